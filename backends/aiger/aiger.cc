@@ -23,16 +23,16 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
-void aiger_encode(std::ostream &f, int x)
+void aiger_encode(std::string &buf, int x)
 {
 	log_assert(x >= 0);
 
 	while (x & ~0x7f) {
-		f.put((x & 0x7f) | 0x80);
+		buf.push_back((x & 0x7f) | 0x80);
 		x = x >> 7;
 	}
 
-	f.put(x);
+	buf.push_back(x);
 }
 
 struct AigerWriter
@@ -61,10 +61,28 @@ struct AigerWriter
 	dict<SigBit, int> init_inputs;
 	int initstate_ff = 0;
 
+	// (<rhs0>, <rhs1>) => <lhs>, for structural hashing in mkgate()
+	dict<pair<int, int>, int> aig_strash;
+
 	int mkgate(int a0, int a1)
 	{
+		if (a0 < a1)
+			std::swap(a0, a1);
+
+		// constant propagation and trivial gates
+		if (a1 == 0 || a0 == (a1 ^ 1))
+			return 0;
+		if (a1 == 1 || a0 == a1)
+			return a0;
+
+		pair<int, int> key(a0, a1);
+		auto it = aig_strash.find(key);
+		if (it != aig_strash.end())
+			return it->second;
+
 		aig_m++, aig_a++;
-		aig_gates.push_back(a0 > a1 ? make_pair(a0, a1) : make_pair(a1, a0));
+		aig_gates.push_back(key);
+		aig_strash[key] = 2*aig_m;
 		return 2*aig_m;
 	}
 
@@ -524,15 +542,18 @@ struct AigerWriter
 			for (int i = aig_obcj; i < aig_obcjf; i++)
 				f << stringf("%d\n", aig_outputs.at(i));
 
+			std::string buffer;
+			buffer.reserve(2*aig_a);
 			for (int i = 0; i < aig_a; i++) {
 				int lhs = 2*(aig_i+aig_l+i)+2;
 				int rhs0 = aig_gates.at(i).first;
 				int rhs1 = aig_gates.at(i).second;
 				int delta0 = lhs - rhs0;
 				int delta1 = rhs0 - rhs1;
-				aiger_encode(f, delta0);
-				aiger_encode(f, delta1);
+				aiger_encode(buffer, delta0);
+				aiger_encode(buffer, delta1);
 			}
+			f.write(buffer.data(), buffer.size());
 		}
 
 		if (symbols_mode)
@@ -86,17 +86,27 @@ struct BlifDumper
 			}
 	}
 
-	vector<shared_str> cstr_buf;
+	// Escaped names are computed once per IdString / SigBit and then handed
+	// out from these caches (shared_str keeps the c_str() pointers stable).
+	dict<RTLIL::IdString, shared_str> cstr_id_cache;
+	dict<RTLIL::SigBit, shared_str> cstr_bit_cache;
 	pool<SigBit> cstr_bits_seen;
 
-	const char *cstr(RTLIL::IdString id)
+	static std::string escape_name(RTLIL::IdString id)
 	{
 		std::string str = RTLIL::unescape_id(id);
 		for (size_t i = 0; i < str.size(); i++)
 			if (str[i] == '#' || str[i] == '=' || str[i] == '<' || str[i] == '>')
 				str[i] = '?';
-		cstr_buf.push_back(str);
-		return cstr_buf.back().c_str();
+		return str;
+	}
+
+	const char *cstr(RTLIL::IdString id)
+	{
+		auto it = cstr_id_cache.find(id);
+		if (it == cstr_id_cache.end())
+			it = cstr_id_cache.insert(std::make_pair(id, shared_str(escape_name(id)))).first;
+		return it->second.c_str();
 	}
 
 	const char *cstr(RTLIL::SigBit sig)
@@ -109,29 +119,26 @@ struct BlifDumper
 			return config->undef_type == "-" || config->undef_type == "+" ? config->undef_out.c_str() : "$undef";
 		}
 
-		std::string str = RTLIL::unescape_id(sig.wire->name);
-		for (size_t i = 0; i < str.size(); i++)
-			if (str[i] == '#' || str[i] == '=' || str[i] == '<' || str[i] == '>')
-				str[i] = '?';
+		auto it = cstr_bit_cache.find(sig);
+		if (it != cstr_bit_cache.end())
+			return it->second.c_str();
 
+		std::string str = cstr(sig.wire->name);
 		if (sig.wire->width != 1)
 			str += stringf("[%d]", sig.wire->upto ? sig.wire->start_offset+sig.wire->width-sig.offset-1 : sig.wire->start_offset+sig.offset);
 
-		cstr_buf.push_back(str);
-		return cstr_buf.back().c_str();
+		return cstr_bit_cache.insert(std::make_pair(sig, shared_str(str))).first->second.c_str();
 	}
 
 	const char *cstr_init(RTLIL::SigBit sig)
 	{
 		sigmap.apply(sig);
 
-		if (init_bits.count(sig) == 0)
+		auto it = init_bits.find(sig);
+		if (it == init_bits.end())
 			return " 2";
 
-		string str = stringf(" %d", init_bits.at(sig));
-
-		cstr_buf.push_back(str);
-		return cstr_buf.back().c_str();
+		return it->second ? " 1" : " 0";
 	}
 
 	const char *subckt_or_gate(std::string cell_type)
@@ -64,6 +64,15 @@ struct BtorWorker
 	// nids for constants
 	dict<Const, int> consts;
 
+	// structural hashing of slice, concat and extend nodes
+	// (<nid>, <upper>, <lower>) => <nid>
+	dict<tuple<int, int, int>, int> slice_nodes;
+	// (<nid_hi>, <nid_lo>) => <nid>
+	dict<pair<int, int>, int> concat_nodes;
+	// (<nid>, <is_signed>, <to_width>) => <nid>
+	dict<tuple<int, int, int>, int> ext_nodes;
+	int reused_nodes = 0;
+
 	// ff inputs that need to be evaluated (<nid>, <ff_cell>)
 	vector<pair<int, Cell*>> ff_todo;
 
@@ -120,6 +129,54 @@ struct BtorWorker
 		return sorts_mem.at(key);
 	}
 
+	int get_slice_nid(int nid, int upper, int lower)
+	{
+		tuple<int, int, int> key(nid, upper, lower);
+		auto it = slice_nodes.find(key);
+		if (it != slice_nodes.end()) {
+			reused_nodes++;
+			return it->second;
+		}
+
+		int sid = get_bv_sid(upper-lower+1);
+		int nid2 = next_nid++;
+		btorf("%d slice %d %d %d %d\n", nid2, sid, nid, upper, lower);
+		slice_nodes[key] = nid2;
+		return nid2;
+	}
+
+	int get_concat_nid(int nid_hi, int nid_lo, int width)
+	{
+		pair<int, int> key(nid_hi, nid_lo);
+		auto it = concat_nodes.find(key);
+		if (it != concat_nodes.end()) {
+			reused_nodes++;
+			return it->second;
+		}
+
+		int sid = get_bv_sid(width);
+		int nid = next_nid++;
+		btorf("%d concat %d %d %d\n", nid, sid, nid_hi, nid_lo);
+		concat_nodes[key] = nid;
+		return nid;
+	}
+
+	int get_ext_nid(int nid, bool is_signed, int from_width, int to_width)
+	{
+		tuple<int, int, int> key(nid, is_signed, to_width);
+		auto it = ext_nodes.find(key);
+		if (it != ext_nodes.end()) {
+			reused_nodes++;
+			return it->second;
+		}
+
+		int sid = get_bv_sid(to_width);
+		int nid2 = next_nid++;
+		btorf("%d %s %d %d %d\n", nid2, is_signed ? "sext" : "uext", sid, nid, to_width - from_width);
+		ext_nodes[key] = nid2;
+		return nid2;
+	}
+
 	void add_nid_sig(int nid, const SigSpec &sig)
 	{
 		if (verbose)
@@ -936,19 +993,13 @@ struct BtorWorker
 
 				int nid3 = nid2;
 
-				if (lower != 0 || upper+1 != nid_width.at(nid2)) {
-					int sid = get_bv_sid(upper-lower+1);
-					nid3 = next_nid++;
-					btorf("%d slice %d %d %d %d\n", nid3, sid, nid2, upper, lower);
-				}
+				if (lower != 0 || upper+1 != nid_width.at(nid2))
+					nid3 = get_slice_nid(nid2, upper, lower);
 
 				int nid4 = nid3;
 
-				if (nid >= 0) {
-					int sid = get_bv_sid(width+upper-lower+1);
-					nid4 = next_nid++;
-					btorf("%d concat %d %d %d\n", nid4, sid, nid3, nid);
-				}
+				if (nid >= 0)
+					nid4 = get_concat_nid(nid3, nid, width+upper-lower+1);
 
 				width += upper-lower+1;
 				nid = nid4;
@@ -964,20 +1015,9 @@ struct BtorWorker
 		if (to_width >= 0 && to_width != GetSize(sig))
 		{
 			if (to_width < GetSize(sig))
-			{
-				int sid = get_bv_sid(to_width);
-				int nid2 = next_nid++;
-				btorf("%d slice %d %d %d 0\n", nid2, sid, nid, to_width-1);
-				nid = nid2;
-			}
+				nid = get_slice_nid(nid, to_width-1, 0);
 			else
-			{
-				int sid = get_bv_sid(to_width);
-				int nid2 = next_nid++;
-				btorf("%d %s %d %d %d\n", nid2, is_signed ? "sext" : "uext",
-						sid, nid, to_width - GetSize(sig));
-				nid = nid2;
-			}
+				nid = get_ext_nid(nid, is_signed, GetSize(sig), to_width);
 		}
 
 		return nid;
@@ -1210,6 +1250,9 @@ struct BtorWorker
 				btorf("%d bad %d\n", nid, todo[cursor]);
 			}
 		}
+
+		if (reused_nodes)
+			log("Re-used %d existing slice/concat/extend nodes.\n", reused_nodes);
 	}
 };
 
@@ -30,16 +30,17 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
-#define EDIF_DEF(_id) edif_names(RTLIL::unescape_id(_id), true).c_str()
-#define EDIF_DEFR(_id, _ren, _bl, _br) edif_names(RTLIL::unescape_id(_id), true, _ren, _bl, _br).c_str()
-#define EDIF_REF(_id) edif_names(RTLIL::unescape_id(_id), false).c_str()
+#define EDIF_DEF(_id) edif_names.def(_id).c_str()
+#define EDIF_DEFR(_id, _ren, _bl, _br) edif_names.def(_id, _ren, _bl, _br).c_str()
+#define EDIF_REF(_id) edif_names.ref(_id).c_str()
 
 struct EdifNames
 {
 	int counter;
 	char delim_left, delim_right;
-	std::set<std::string> generated_names, used_names;
-	std::map<std::string, std::string> name_map;
+	pool<std::string> generated_names, used_names;
+	dict<std::string, std::string> name_map;
+	dict<RTLIL::IdString, std::string> id_cache;
 
 	EdifNames() : counter(1), delim_left('['), delim_right(']') { }
 
@@ -86,8 +87,42 @@ struct EdifNames
 		name_map[id] = gen_name;
 		return gen_name;
 	}
+
+	// The EDIF name of an identifier never changes once it has been handed
+	// out, so the escaped form is cached per IdString.
+	std::string ref(RTLIL::IdString id)
+	{
+		auto it = id_cache.find(id);
+		if (it == id_cache.end())
+			it = id_cache.insert(std::make_pair(id, operator()(RTLIL::unescape_id(id), false))).first;
+		return it->second;
+	}
+
+	std::string ref(const std::string &id)
+	{
+		return operator()(RTLIL::unescape_id(id), false);
+	}
+
+	template<typename T>
+	std::string def(const T &id, bool port_rename = false, int range_left = 0, int range_right = 0)
+	{
+		std::string name = RTLIL::unescape_id(id);
+		std::string new_id = ref(id);
+		if (port_rename)
+			return stringf("(rename %s \"%s%c%d:%d%c\")", new_id.c_str(), name.c_str(), delim_left, range_left, range_right, delim_right);
+		return new_id != name ? stringf("(rename %s \"%s\")", new_id.c_str(), name.c_str()) : name;
+	}
 };
 
+std::string edif_netname(RTLIL::SigBit bit)
+{
+	std::string netname;
+	for (char c : std::string(log_signal(bit)))
+		if (c != ' ' && c != '\\')
+			netname += c;
+	return netname;
+}
+
 struct EdifBackend : public Backend {
 	EdifBackend() : Backend("edif", "write design to EDIF netlist file") { }
 	void help() YS_OVERRIDE
@@ -313,16 +348,16 @@ struct EdifBackend : public Backend {
 			else if (val.bits.size() <= 32 && RTLIL::SigSpec(val).is_fully_def())
 				*f << stringf("\n            (property %s (integer %u))", EDIF_DEF(name), val.as_int());
 			else {
-				std::string hex_string = "";
+				std::string hex_string;
 				for (size_t i = 0; i < val.bits.size(); i += 4) {
 					int digit_value = 0;
 					if (i+0 < val.bits.size() && val.bits.at(i+0) == RTLIL::State::S1) digit_value |= 1;
 					if (i+1 < val.bits.size() && val.bits.at(i+1) == RTLIL::State::S1) digit_value |= 2;
 					if (i+2 < val.bits.size() && val.bits.at(i+2) == RTLIL::State::S1) digit_value |= 4;
 					if (i+3 < val.bits.size() && val.bits.at(i+3) == RTLIL::State::S1) digit_value |= 8;
-					char digit_str[2] = { "0123456789abcdef"[digit_value], 0 };
-					hex_string = std::string(digit_str) + hex_string;
+					hex_string += "0123456789abcdef"[digit_value];
 				}
+				std::reverse(hex_string.begin(), hex_string.end());
 				*f << stringf("\n            (property %s (string \"%d'h%s\"))", EDIF_DEF(name), GetSize(val.bits), hex_string.c_str());
 			}
 		};		
@@ -380,6 +415,7 @@ struct EdifBackend : public Backend {
 			}
 			for (auto &cell_it : module->cells_) {
 				RTLIL::Cell *cell = cell_it.second;
+				RTLIL::Module *cell_module = design->module(cell->type);
 				*f << stringf("          (instance %s\n", EDIF_DEF(cell->name));
 				*f << stringf("            (viewRef VIEW_NETLIST (cellRef %s%s))", EDIF_REF(cell->type),
 						lib_cell_ports.count(cell->type) > 0 ? " (libraryRef LIB)" : "");
@@ -398,10 +434,9 @@ struct EdifBackend : public Backend {
 									i, log_id(module), log_id(cell), log_id(p.first), log_signal(sig[i]));
 						else {
 							int member_idx = GetSize(sig)-i-1;
-							auto m = design->module(cell->type);
 							int width = sig.size();
-							if (m) {
-								auto w = m->wire(p.first);
+							if (cell_module) {
+								auto w = cell_module->wire(p.first);
 								if (w) {
 									member_idx = GetSize(w)-i-1;
 									width = GetSize(w);
@@ -436,15 +471,11 @@ struct EdifBackend : public Backend {
 					netname = "GND_NET";
 				else if (sig == RTLIL::State::S1)
 					netname = "VCC_NET";
-				else {
-					netname = log_signal(sig);
-					for (size_t i = 0; i < netname.size(); i++)
-						if (netname[i] == ' ' || netname[i] == '\\')
-							netname.erase(netname.begin() + i--);
-				}
+				else
+					netname = edif_netname(sig);
 				*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
 				for (auto &ref : it.second)
-					*f << stringf("            %s\n", ref.first.c_str());
+					*f << "            " << ref.first << "\n";
 				if (sig.wire == NULL) {
 					if (nogndvcc)
 						log_error("Design contains constant nodes (map with \"hilomap\" first).\n");
@@ -468,15 +499,12 @@ struct EdifBackend : public Backend {
 					SigBit mapped_sig = sigmap(raw_sig);
 					if (raw_sig == mapped_sig || net_join_db.count(mapped_sig) == 0)
 						continue;
-					std::string netname = log_signal(raw_sig);
-					for (size_t i = 0; i < netname.size(); i++)
-						if (netname[i] == ' ' || netname[i] == '\\')
-							netname.erase(netname.begin() + i--);
+					std::string netname = edif_netname(raw_sig);
 					*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
 					auto &refs = net_join_db.at(mapped_sig);
 					for (auto &ref : refs)
 						if (ref.second)
-							*f << stringf("            %s\n", ref.first.c_str());
+							*f << "            " << ref.first << "\n";
 					*f << stringf("            )");
 					if (attr_properties && raw_sig.wire != NULL)
 						for (auto &p : raw_sig.wire->attributes)
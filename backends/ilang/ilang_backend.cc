@@ -46,22 +46,26 @@ void ILANG_BACKEND::dump_const(std::ostream &f, const RTLIL::Const &data, int wi
 				}
 			}
 			if (val >= 0) {
-				f << stringf("%d", val);
+				f << val;
 				return;
 			}
 		}
-		f << stringf("%d'", width);
+		// build the bit string first and write it in one go, large init values
+		// and LUT masks make this a hot path when writing big designs
+		log_assert(offset+width <= (int)data.bits.size());
+		std::string bits_str;
+		bits_str.reserve(width);
 		for (int i = offset+width-1; i >= offset; i--) {
-			log_assert(i < (int)data.bits.size());
 			switch (data.bits[i]) {
-			case State::S0: f << stringf("0"); break;
-			case State::S1: f << stringf("1"); break;
-			case RTLIL::Sx: f << stringf("x"); break;
-			case RTLIL::Sz: f << stringf("z"); break;
-			case RTLIL::Sa: f << stringf("-"); break;
-			case RTLIL::Sm: f << stringf("m"); break;
+			case State::S0: bits_str += '0'; break;
+			case State::S1: bits_str += '1'; break;
+			case RTLIL::Sx: bits_str += 'x'; break;
+			case RTLIL::Sz: bits_str += 'z'; break;
+			case RTLIL::Sa: bits_str += '-'; break;
+			case RTLIL::Sm: bits_str += 'm'; break;
 			}
 		}
+		f << width << '\'' << bits_str;
 	} else {
 		f << stringf("\"");
 		std::string str = data.decode_string();
@@ -89,11 +93,11 @@ void ILANG_BACKEND::dump_sigchunk(std::ostream &f, const RTLIL::SigChunk &chunk,
 		dump_const(f, chunk.data, chunk.width, chunk.offset, autoint);
 	} else {
 		if (chunk.width == chunk.wire->width && chunk.offset == 0)
-			f << stringf("%s", chunk.wire->name.c_str());
+			f << chunk.wire->name.c_str();
 		else if (chunk.width == 1)
-			f << stringf("%s [%d]", chunk.wire->name.c_str(), chunk.offset);
+			f << chunk.wire->name.c_str() << " [" << chunk.offset << "]";
 		else
-			f << stringf("%s [%d:%d]", chunk.wire->name.c_str(), chunk.offset+chunk.width-1, chunk.offset);
+			f << chunk.wire->name.c_str() << " [" << chunk.offset+chunk.width-1 << ":" << chunk.offset << "]";
 	}
 }
 
@@ -102,12 +106,12 @@ void ILANG_BACKEND::dump_sigspec(std::ostream &f, const RTLIL::SigSpec &sig, boo
 	if (sig.is_chunk()) {
 		dump_sigchunk(f, sig.as_chunk(), autoint);
 	} else {
-		f << stringf("{ ");
+		f << "{ ";
 		for (auto it = sig.chunks().rbegin(); it != sig.chunks().rend(); ++it) {
 			dump_sigchunk(f, *it, false);
-			f << stringf(" ");
+			f << ' ';
 		}
-		f << stringf("}");
+		f << '}';
 	}
 }
 
@@ -40,16 +40,17 @@ struct JsonWriter
 
 	SigMap sigmap;
 	int sigidcounter;
-	dict<SigBit, string> sigids;
+	dict<SigBit, int> sigids;
 	pool<Aig> aig_models;
 
 	JsonWriter(std::ostream &f, bool use_selection, bool aig_mode, bool compat_int_mode) :
 			f(f), use_selection(use_selection), aig_mode(aig_mode),
 			compat_int_mode(compat_int_mode) { }
 
-	string get_string(string str)
+	string get_string(const string &str)
 	{
 		string newstr = "\"";
+		newstr.reserve(str.size() + 2);
 		for (char c : str) {
 			if (c == '\\')
 				newstr += c;
@@ -67,20 +68,21 @@ struct JsonWriter
 	{
 		bool first = true;
 		string str = "[";
+		str.reserve(4 + 8 * GetSize(sig));
 		for (auto bit : sigmap(sig)) {
 			str += first ? " " : ", ";
 			first = false;
-			if (sigids.count(bit) == 0) {
-				string &s = sigids[bit];
-				if (bit.wire == nullptr) {
-					if (bit == State::S0) s = "\"0\"";
-					else if (bit == State::S1) s = "\"1\"";
-					else if (bit == State::Sz) s = "\"z\"";
-					else s = "\"x\"";
-				} else
-					s = stringf("%d", sigidcounter++);
+			if (bit.wire == nullptr) {
+				if (bit == State::S0) str += "\"0\"";
+				else if (bit == State::S1) str += "\"1\"";
+				else if (bit == State::Sz) str += "\"z\"";
+				else str += "\"x\"";
+				continue;
 			}
-			str += sigids[bit];
+			auto it = sigids.find(bit);
+			if (it == sigids.end())
+				it = sigids.insert(std::make_pair(bit, sigidcounter++)).first;
+			str += std::to_string(it->second);
 		}
 		return str + " ]";
 	}
@@ -154,7 +156,7 @@ struct JsonWriter
 				f << stringf("          \"offset\": %d,\n", w->start_offset);
 			if (w->upto)
 				f << stringf("          \"upto\": 1,\n");
-			f << stringf("          \"bits\": %s\n", get_bits(w).c_str());
+			f << "          \"bits\": " << get_bits(w) << "\n";
 			f << stringf("        }");
 			first = false;
 		}
@@ -199,7 +201,7 @@ struct JsonWriter
 			bool first2 = true;
 			for (auto &conn : c->connections()) {
 				f << stringf("%s\n", first2 ? "" : ",");
-				f << stringf("            %s: %s", get_name(conn.first).c_str(), get_bits(conn.second).c_str());
+				f << "            " << get_name(conn.first) << ": " << get_bits(conn.second);
 				first2 = false;
 			}
 			f << stringf("\n          }\n");
@@ -216,7 +218,7 @@ struct JsonWriter
 			f << stringf("%s\n", first ? "" : ",");
 			f << stringf("        %s: {\n", get_name(w->name).c_str());
 			f << stringf("          \"hide_name\": %s,\n", w->name[0] == '$' ? "1" : "0");
-			f << stringf("          \"bits\": %s,\n", get_bits(w).c_str());
+			f << "          \"bits\": " << get_bits(w) << ",\n";
 			if (w->start_offset)
 				f << stringf("          \"offset\": %d,\n", w->start_offset);
 			if (w->upto)
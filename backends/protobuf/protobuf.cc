@@ -35,7 +35,6 @@ struct ProtobufDesignSerializer
 {
 	bool aig_mode_;
 	bool use_selection_;
-	yosys::pb::Design *pb_;
 
 	Design *design_;
 	Module *module_;
@@ -66,10 +65,17 @@ struct ProtobufDesignSerializer
 
 			if ((param.second.flags & RTLIL::ConstFlags::CONST_FLAG_STRING) != 0) {
 				pb_param.set_str(param.second.decode_string());
-			} else if (GetSize(param.second.bits) > 64) {
+			} else if (GetSize(param.second.bits) > 64 || !param.second.is_fully_def()) {
 				pb_param.set_str(param.second.as_string());
+			} else if (GetSize(param.second.bits) > 32) {
+				uint64_t value = 0;
+				for (int i = GetSize(param.second.bits)-1; i >= 0; i--)
+					value = (value << 1) | (param.second.bits[i] == State::S1);
+				pb_param.set_int_(value);
+				pb_param.set_width(GetSize(param.second.bits));
 			} else {
 				pb_param.set_int_(param.second.as_int());
+				pb_param.set_width(GetSize(param.second.bits));
 			}
 
 			(*out)[key] = pb_param;
@@ -160,6 +166,7 @@ struct ProtobufDesignSerializer
 				continue;
 
 			auto netname = out->add_netname();
+			netname->set_name(get_name(w->name));
 			netname->set_hide_name(w->name[0] == '$');
 			get_bits(netname->mutable_bits(), w);
 			serialize_parameters(netname->mutable_attributes(), w->attributes);
@@ -208,24 +215,40 @@ struct ProtobufDesignSerializer
 		}
 	}
 
-	void serialize_design(yosys::pb::Design *pb, Design *design)
+	void write_message(std::ostream *f, bool text_mode, const yosys::pb::Design &pb)
+	{
+		if (text_mode) {
+			string out;
+			google::protobuf::TextFormat::PrintToString(pb, &out);
+			*f << out;
+		} else {
+			pb.SerializeToOstream(f);
+		}
+	}
+
+	// Every module is written as a Design message of its own as soon as it
+	// has been serialized. Concatenated messages merge into a single Design
+	// on the reading side, so only one module is held in memory at a time.
+	void serialize_design(std::ostream *f, bool text_mode, Design *design)
 	{
 		GOOGLE_PROTOBUF_VERIFY_VERSION;
-		pb_ = pb;
-		pb_->Clear();
-		pb_->set_creator(yosys_version_str);
+		yosys::pb::Design pb;
+		pb.set_creator(yosys_version_str);
+		write_message(f, text_mode, pb);
 
 		design_ = design;
 		design_->sort();
 
 		auto modules = use_selection_ ? design_->selected_modules() : design_->modules();
 		for (auto mod : modules) {
-			yosys::pb::Module pb_mod;
-			serialize_module(&pb_mod, mod);
-			(*pb->mutable_modules())[mod->name.str()] = pb_mod;
+			pb.Clear();
+			serialize_module(&(*pb.mutable_modules())[mod->name.str()], mod);
+			write_message(f, text_mode, pb);
 		}
 
-		serialize_models(pb_->mutable_models());
+		pb.Clear();
+		serialize_models(pb.mutable_models());
+		write_message(f, text_mode, pb);
 	}
 };
 
@@ -237,7 +260,8 @@ struct ProtobufBackend : public Backend {
 		log("\n");
 		log("    write_protobuf [options] [filename]\n");
 		log("\n");
-		log("Write a JSON netlist of the current design.\n");
+		log("Write a Protocol Buffer netlist of the current design. The design is written\n");
+		log("one module at a time; use read_protobuf to load it back.\n");
 		log("\n");
 		log("    -aig\n");
 		log("        include AIG models for the different gate types\n");
@@ -245,7 +269,7 @@ struct ProtobufBackend : public Backend {
 		log("    -text\n");
 		log("        output protobuf in Text/ASCII representation\n");
 		log("\n");
-		log("The schema of the output Protocol Buffer is defined in misc/yosys.pb in the\n");
+		log("The schema of the output Protocol Buffer is defined in misc/yosys.proto in the\n");
 		log("Yosys source code distribution.\n");
 		log("\n");
 	}
@@ -270,17 +294,8 @@ struct ProtobufBackend : public Backend {
 
 		log_header(design, "Executing Protobuf backend.\n");
 
-		yosys::pb::Design pb;
 		ProtobufDesignSerializer serializer(false, aig_mode);
-		serializer.serialize_design(&pb, design);
-
-		if (text_mode) {
-			string out;
-			google::protobuf::TextFormat::PrintToString(pb, &out);
-			*f << out;
-		} else {
-			pb.SerializeToOstream(f);
-		}
+		serializer.serialize_design(f, text_mode, design);
 	}
 } ProtobufBackend;
 
@@ -292,7 +307,7 @@ struct ProtobufPass : public Pass {
 		log("\n");
 		log("    protobuf [options] [selection]\n");
 		log("\n");
-		log("Write a JSON netlist of all selected objects.\n");
+		log("Write a Protocol Buffer netlist of all selected objects.\n");
 		log("\n");
 		log("    -o <filename>\n");
 		log("        write to the specified file.\n");
@@ -303,7 +318,7 @@ struct ProtobufPass : public Pass {
 		log("    -text\n");
 		log("        output protobuf in Text/ASCII representation\n");
 		log("\n");
-		log("The schema of the output Protocol Buffer is defined in misc/yosys.pb in the\n");
+		log("The schema of the output Protocol Buffer is defined in misc/yosys.proto in the\n");
 		log("Yosys source code distribution.\n");
 		log("\n");
 	}
@@ -348,17 +363,8 @@ struct ProtobufPass : public Pass {
 			f = &buf;
 		}
 
-		yosys::pb::Design pb;
 		ProtobufDesignSerializer serializer(true, aig_mode);
-		serializer.serialize_design(&pb, design);
-
-		if (text_mode) {
-			string out;
-			google::protobuf::TextFormat::PrintToString(pb, &out);
-			*f << out;
-		} else {
-			pb.SerializeToOstream(f);
-		}
+		serializer.serialize_design(f, text_mode, design);
 
 		if (!filename.empty()) {
 			delete f;
@@ -0,0 +1,294 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/register.h"
+#include "kernel/log.h"
+#include "backends/rtlil_bin/rtlil_bin.h"
+#include <algorithm>
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+// hashlib containers iterate in reverse order of insertion. entries are stored in
+// insertion order, so that the reader recreates the containers in the same order.
+template<typename K, typename T>
+std::vector<const std::pair<K, T>*> insertion_order(const dict<K, T> &d)
+{
+	std::vector<const std::pair<K, T>*> result;
+	for (auto &it : d)
+		result.push_back(&it);
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+
+template<typename K>
+std::vector<K> insertion_order(const pool<K> &p)
+{
+	std::vector<K> result(p.begin(), p.end());
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+
+struct RtlilBinWriter
+{
+	dict<RTLIL::IdString, int> string_index;
+	std::vector<RTLIL::IdString> strings;
+	dict<RTLIL::Wire*, int> wire_index;
+	std::string buf;
+
+	void put_uint(uint64_t value)
+	{
+		while (value >= 0x80) {
+			buf += char((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		buf += char(value);
+	}
+
+	void put_int(int64_t value)
+	{
+		put_uint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+	}
+
+	int string_id(RTLIL::IdString id)
+	{
+		auto it = string_index.find(id);
+		if (it == string_index.end()) {
+			it = string_index.insert(std::make_pair(id, GetSize(strings))).first;
+			strings.push_back(id);
+		}
+		return it->second;
+	}
+
+	void put_id(RTLIL::IdString id)
+	{
+		put_uint(string_id(id));
+	}
+
+	void put_bits(const std::vector<RTLIL::State> &bits)
+	{
+		bool only_01 = true;
+		for (auto bit : bits)
+			if (bit != State::S0 && bit != State::S1)
+				only_01 = false;
+
+		put_uint(bits.size());
+		buf += char(only_01 ? RTLIL_BIN::PACK_BITS : RTLIL_BIN::PACK_NIBBLES);
+
+		int per_byte = only_01 ? 8 : 2;
+		for (size_t i = 0; i < bits.size(); i += per_byte) {
+			unsigned char byte = 0;
+			for (size_t j = 0; j < size_t(per_byte) && i+j < bits.size(); j++)
+				byte |= bits[i+j] << (j * (8 / per_byte));
+			buf += char(byte);
+		}
+	}
+
+	void put_const(const RTLIL::Const &value)
+	{
+		put_uint(value.flags);
+		put_bits(value.bits);
+	}
+
+	void put_sigspec(const RTLIL::SigSpec &sig)
+	{
+		put_uint(GetSize(sig.chunks()));
+		for (auto &chunk : sig.chunks()) {
+			if (chunk.wire == nullptr) {
+				put_uint(0);
+				put_bits(chunk.data);
+			} else {
+				put_uint(wire_index.at(chunk.wire) + 1);
+				put_uint(chunk.offset);
+				put_uint(chunk.width);
+			}
+		}
+	}
+
+	void put_sigsigs(const std::vector<RTLIL::SigSig> &sigsigs)
+	{
+		put_uint(sigsigs.size());
+		for (auto &it : sigsigs) {
+			put_sigspec(it.first);
+			put_sigspec(it.second);
+		}
+	}
+
+	void put_consts(const dict<RTLIL::IdString, RTLIL::Const> &consts)
+	{
+		put_uint(GetSize(consts));
+		for (auto it : insertion_order(consts)) {
+			put_id(it->first);
+			put_const(it->second);
+		}
+	}
+
+	void put_case(const RTLIL::CaseRule *cs)
+	{
+		put_consts(cs->attributes);
+		put_uint(cs->compare.size());
+		for (auto &sig : cs->compare)
+			put_sigspec(sig);
+		put_sigsigs(cs->actions);
+		put_uint(cs->switches.size());
+		for (auto sw : cs->switches)
+			put_switch(sw);
+	}
+
+	void put_switch(const RTLIL::SwitchRule *sw)
+	{
+		put_consts(sw->attributes);
+		put_sigspec(sw->signal);
+		put_uint(sw->cases.size());
+		for (auto cs : sw->cases)
+			put_case(cs);
+	}
+
+	void put_module(RTLIL::Module *module)
+	{
+		put_consts(module->attributes);
+
+		put_uint(GetSize(module->avail_parameters));
+		for (auto &param : insertion_order(module->avail_parameters))
+			put_id(param);
+
+		wire_index.clear();
+		put_uint(GetSize(module->wires_));
+		for (auto it : insertion_order(module->wires_)) {
+			RTLIL::Wire *wire = it->second;
+			int index = GetSize(wire_index);
+			wire_index[wire] = index;
+			put_id(wire->name);
+			put_uint(wire->width);
+			put_int(wire->start_offset);
+			put_uint(wire->port_id);
+			put_uint((wire->port_input ? RTLIL_BIN::WIRE_INPUT : 0) | (wire->port_output ? RTLIL_BIN::WIRE_OUTPUT : 0) |
+					(wire->upto ? RTLIL_BIN::WIRE_UPTO : 0));
+			put_consts(wire->attributes);
+		}
+
+		put_uint(GetSize(module->memories));
+		for (auto it : insertion_order(module->memories)) {
+			RTLIL::Memory *memory = it->second;
+			put_id(memory->name);
+			put_uint(memory->width);
+			put_int(memory->start_offset);
+			put_uint(memory->size);
+			put_consts(memory->attributes);
+		}
+
+		put_uint(GetSize(module->cells_));
+		for (auto it : insertion_order(module->cells_)) {
+			RTLIL::Cell *cell = it->second;
+			put_id(cell->name);
+			put_id(cell->type);
+			put_consts(cell->parameters);
+			put_consts(cell->attributes);
+			put_uint(GetSize(cell->connections()));
+			for (auto conn : insertion_order(cell->connections())) {
+				put_id(conn->first);
+				put_sigspec(conn->second);
+			}
+		}
+
+		put_uint(GetSize(module->processes));
+		for (auto it : insertion_order(module->processes)) {
+			RTLIL::Process *proc = it->second;
+			put_id(proc->name);
+			put_consts(proc->attributes);
+			put_case(&proc->root_case);
+			put_uint(proc->syncs.size());
+			for (auto sync : proc->syncs) {
+				put_uint(sync->type);
+				put_sigspec(sync->signal);
+				put_sigsigs(sync->actions);
+			}
+		}
+
+		put_sigsigs(module->connections());
+	}
+
+	void write(std::ostream &f, RTLIL::Design *design)
+	{
+		std::vector<std::pair<RTLIL::IdString, std::string>> module_records;
+		for (auto it : insertion_order(design->modules_)) {
+			buf.clear();
+			put_module(it->second);
+			string_id(it->first);
+			module_records.push_back(std::make_pair(it->first, buf));
+		}
+
+		buf.clear();
+		buf.append(RTLIL_BIN::magic, RTLIL_BIN::magic_len);
+		put_uint(RTLIL_BIN::version);
+		put_uint(autoidx);
+		put_uint(strings.size());
+		f.write(buf.data(), buf.size());
+		for (auto &str : strings) {
+			buf.clear();
+			put_uint(str.size());
+			buf += str.str();
+			f.write(buf.data(), buf.size());
+		}
+
+		buf.clear();
+		put_uint(module_records.size());
+		f.write(buf.data(), buf.size());
+		for (auto &it : module_records) {
+			buf.clear();
+			put_id(it.first);
+			put_uint(it.second.size());
+			f.write(buf.data(), buf.size());
+			f.write(it.second.data(), it.second.size());
+		}
+	}
+};
+
+struct RtlilBinBackend : public Backend {
+	RtlilBinBackend() : Backend("rtlil_bin", "write design to a binary checkpoint file") { }
+	void help() YS_OVERRIDE
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    write_rtlil_bin [filename]\n");
+		log("\n");
+		log("Write the whole design (including processes, memories and the current value\n");
+		log("of autoidx) to a compact binary file that can be read back with\n");
+		log("'read_rtlil_bin'. This is intended for checkpoints in long flows: the file is\n");
+		log("much smaller and faster to read than an ilang file of the same design.\n");
+		log("\n");
+		log("The format is specific to this version of Yosys and is not meant for exchanging\n");
+		log("designs with other tools.\n");
+		log("\n");
+	}
+	void execute(std::ostream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
+	{
+		log_header(design, "Executing RTLIL_BIN backend.\n");
+
+		size_t argidx = 1;
+		extra_args(f, filename, args, argidx, true);
+
+		log("Output filename: %s\n", filename.c_str());
+
+		RtlilBinWriter writer;
+		writer.write(*f, design);
+	}
+} RtlilBinBackend;
+
+PRIVATE_NAMESPACE_END
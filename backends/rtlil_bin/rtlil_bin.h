@@ -0,0 +1,66 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  A compact binary representation of a whole design, used for checkpoints
+ *  (written by 'write_rtlil_bin' and read by 'read_rtlil_bin').
+ *
+ *  All integers are stored as LEB128 varints, signed integers zigzag encoded.
+ *  A file has the following layout:
+ *
+ *    magic "YSRTLBIN", format version, autoidx
+ *    string table: number of strings, then length and bytes of each string
+ *    number of modules, then for each module: name, size of the module
+ *      record in bytes, and the module record
+ *
+ *  All IdStrings are stored as indices into the string table. The module
+ *  sizes allow a reader to skip modules without decoding them. In a module
+ *  record, wires are numbered in the order they are stored and signals
+ *  refer to wires by that number. Constants are stored with their flags,
+ *  their width and their bits packed to one bit per bit (if they only
+ *  contain 0 and 1) or four bits per bit.
+ *
+ */
+
+#ifndef RTLIL_BIN_H
+#define RTLIL_BIN_H
+
+#include "kernel/yosys.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+namespace RTLIL_BIN {
+	const char magic[] = "YSRTLBIN";
+	const int magic_len = 8;
+	const int version = 1;
+
+	enum ConstPacking {
+		PACK_BITS = 0,
+		PACK_NIBBLES = 1
+	};
+
+	enum WireFlags {
+		WIRE_INPUT = 1,
+		WIRE_OUTPUT = 2,
+		WIRE_UPTO = 4
+	};
+}
+
+YOSYS_NAMESPACE_END
+
+#endif
@@ -60,6 +60,11 @@ static string cid(IdString id)
 	return id2cid.at(id);
 }
 
+static bool is_dff(Cell *cell)
+{
+	return cell->type.in("$_DFF_N_", "$_DFF_P_", "$dff");
+}
+
 struct HierDirtyFlags
 {
 	int dirty;
@@ -282,6 +287,192 @@ struct SimplecWorker
 		return stringf("  %s(&%s, %s);", util_name.c_str(), signame.c_str(), expr.c_str());
 	}
 
+	// the value_<hi>_<lo> fields of sigtype(n), as pairs of (lo, hi)
+	vector<pair<int, int>> sigfields(int n)
+	{
+		vector<pair<int, int>> fields;
+
+		for (int k = 8; k <= max_uintsize; k = 2*k)
+			if (n <= k) {
+				fields.push_back(pair<int, int>(0, n-1));
+				return fields;
+			}
+
+		for (int k = 0; k < n; k += max_uintsize)
+			fields.push_back(pair<int, int>(k, std::min(n, k+max_uintsize)-1));
+		return fields;
+	}
+
+	string util_get_bits(const string &signame, int n, int offset, int width)
+	{
+		log_assert(width <= 64);
+
+		string util_name = stringf("yosys_simplec_get_bits_%d_%d_of_%d", offset+width-1, offset, n);
+
+		if (generated_utils.count(util_name) == 0)
+		{
+			util_ifdef_guard(util_name);
+			util_declarations.push_back(stringf("static inline uint64_t %s(const %s *sig)", util_name.c_str(), sigtype(n).c_str()));
+			util_declarations.push_back(stringf("{"));
+			util_declarations.push_back(stringf("  uint64_t value = 0;"));
+
+			for (auto &field : sigfields(n)) {
+				int lo = std::max(offset, field.first), hi = std::min(offset+width-1, field.second);
+				if (lo > hi)
+					continue;
+				uint64_t mask = hi-lo+1 == 64 ? ~uint64_t(0) : (uint64_t(1) << (hi-lo+1)) - 1;
+				util_declarations.push_back(stringf("  value |= (((uint64_t)sig->value_%d_%d >> %d) & 0x%llxULL) << %d;",
+						field.second, field.first, lo-field.first, (unsigned long long)mask, lo-offset));
+			}
+
+			util_declarations.push_back(stringf("  return value;"));
+			util_declarations.push_back(stringf("}"));
+			util_declarations.push_back(stringf("#endif"));
+			generated_utils.insert(util_name);
+		}
+
+		return stringf("%s(&%s)", util_name.c_str(), signame.c_str());
+	}
+
+	string util_set_bits(const string &signame, int n, int offset, int width, const string &expr)
+	{
+		log_assert(width <= 64);
+
+		string util_name = stringf("yosys_simplec_set_bits_%d_%d_of_%d", offset+width-1, offset, n);
+
+		if (generated_utils.count(util_name) == 0)
+		{
+			util_ifdef_guard(util_name);
+			util_declarations.push_back(stringf("static inline void %s(%s *sig, uint64_t value)", util_name.c_str(), sigtype(n).c_str()));
+			util_declarations.push_back(stringf("{"));
+
+			for (auto &field : sigfields(n)) {
+				int lo = std::max(offset, field.first), hi = std::min(offset+width-1, field.second);
+				if (lo > hi)
+					continue;
+				uint64_t mask = hi-lo+1 == 64 ? ~uint64_t(0) : (uint64_t(1) << (hi-lo+1)) - 1;
+				util_declarations.push_back(stringf("  sig->value_%d_%d = ((uint64_t)sig->value_%d_%d & ~(0x%llxULL << %d)) | (((value >> %d) & 0x%llxULL) << %d);",
+						field.second, field.first, field.second, field.first, (unsigned long long)mask, lo-field.first,
+						lo-offset, (unsigned long long)mask, lo-field.first));
+			}
+
+			util_declarations.push_back(stringf("}"));
+			util_declarations.push_back(stringf("#endif"));
+			generated_utils.insert(util_name);
+		}
+
+		return stringf("  %s(&%s, %s);", util_name.c_str(), signame.c_str(), expr.c_str());
+	}
+
+	string util_sext(const string &expr, int width)
+	{
+		if (width >= 64)
+			return expr;
+
+		string util_name = "yosys_simplec_sext";
+
+		if (generated_utils.count(util_name) == 0)
+		{
+			util_ifdef_guard(util_name);
+			util_declarations.push_back(stringf("static inline uint64_t %s(uint64_t value, int width)", util_name.c_str()));
+			util_declarations.push_back(stringf("{"));
+			util_declarations.push_back(stringf("  uint64_t sign = (uint64_t)1 << (width - 1);"));
+			util_declarations.push_back(stringf("  return ((value & (sign | (sign - 1))) ^ sign) - sign;"));
+			util_declarations.push_back(stringf("}"));
+			util_declarations.push_back(stringf("#endif"));
+			generated_utils.insert(util_name);
+		}
+
+		return stringf("%s(%s, %d)", util_name.c_str(), expr.c_str(), width);
+	}
+
+	string util_parity(const string &expr)
+	{
+		string util_name = "yosys_simplec_parity";
+
+		if (generated_utils.count(util_name) == 0)
+		{
+			util_ifdef_guard(util_name);
+			util_declarations.push_back(stringf("static inline bool %s(uint64_t value)", util_name.c_str()));
+			util_declarations.push_back(stringf("{"));
+			util_declarations.push_back(stringf("  for (int i = 32; i > 0; i /= 2)"));
+			util_declarations.push_back(stringf("    value ^= value >> i;"));
+			util_declarations.push_back(stringf("  return value & 1;"));
+			util_declarations.push_back(stringf("}"));
+			util_declarations.push_back(stringf("#endif"));
+			generated_utils.insert(util_name);
+		}
+
+		return stringf("%s(%s)", util_name.c_str(), expr.c_str());
+	}
+
+	// C expression for the value of a (sigmapped) signal of up to 64 bits, as uint64_t
+	string word_expr(HierDirtyFlags *work, const SigSpec &sig)
+	{
+		log_assert(GetSize(sig) <= 64);
+
+		vector<string> parts;
+		int pos = 0;
+
+		for (auto &chunk : sig.chunks())
+		{
+			string expr;
+
+			if (chunk.wire) {
+				expr = util_get_bits(work->prefix + cid(chunk.wire->name), chunk.wire->width, chunk.offset, chunk.width);
+			} else {
+				uint64_t value = 0;
+				for (int i = 0; i < chunk.width; i++)
+					if (chunk.data[i] == State::S1)
+						value |= uint64_t(1) << i;
+				if (value != 0)
+					expr = stringf("0x%llxULL", (unsigned long long)value);
+			}
+
+			if (!expr.empty())
+				parts.push_back(pos ? stringf("(%s << %d)", expr.c_str(), pos) : expr);
+			pos += chunk.width;
+		}
+
+		if (parts.empty())
+			return "(uint64_t)0";
+		if (GetSize(parts) == 1)
+			return parts.front();
+
+		string expr = "(" + parts.front();
+		for (int i = 1; i < GetSize(parts); i++)
+			expr += " | " + parts[i];
+		return expr + ")";
+	}
+
+	// assign a uint64_t C expression to a (sigmapped) signal of up to 64 bits
+	void set_word(HierDirtyFlags *work, const SigSpec &sig, const string &expr, const string &comment)
+	{
+		vector<string> assignments;
+		int pos = 0;
+
+		for (auto &chunk : sig.chunks()) {
+			log_assert(chunk.wire);
+			assignments.push_back(util_set_bits(work->prefix + cid(chunk.wire->name), chunk.wire->width, chunk.offset, chunk.width,
+					pos ? stringf("value >> %d", pos) : "value"));
+			pos += chunk.width;
+		}
+
+		if (GetSize(assignments) == 1) {
+			funct_declarations.push_back(util_set_bits(work->prefix + cid(sig.chunks().front().wire->name), sig.chunks().front().wire->width,
+					sig.chunks().front().offset, sig.chunks().front().width, expr) + comment);
+		} else {
+			funct_declarations.push_back("  {" + comment);
+			funct_declarations.push_back(stringf("    uint64_t value = %s;", expr.c_str()));
+			for (auto &line : assignments)
+				funct_declarations.push_back("  " + line);
+			funct_declarations.push_back("  }");
+		}
+
+		for (auto bit : sig)
+			work->set_dirty(bit);
+	}
+
 	void create_module_struct(Module *mod)
 	{
 		if (generated_structs.count(mod->name))
@@ -316,15 +507,21 @@ struct SimplecWorker
 				create_module_struct(design->module(c->type));
 		}
 
+		// levelize the cells: each cell comes after the cells driving its inputs, so
+		// that evaluating the dirty cells in this order evaluates each cell only once
 		TopoSort<IdString> topo;
 
 		for (Cell *c : mod->cells())
 		{
 			topo.node(c->name);
 
+			// flip-flop outputs only change in the _tick() function
+			if (is_dff(c))
+				continue;
+
 			for (auto &conn : c->connections())
 			{
-				if (!c->input(conn.first))
+				if (c->input(conn.first))
 					continue;
 
 				for (auto bit : sigmaps.at(mod)(conn.second))
@@ -378,12 +575,18 @@ struct SimplecWorker
 
 	void eval_cell(HierDirtyFlags *work, Cell *cell)
 	{
+		if (is_dff(cell))
+		{
+			// flip-flops only change their state in the _tick() function
+			return;
+		}
+
 		if (cell->type.in("$_BUF_", "$_NOT_"))
 		{
 			SigBit a = sigmaps.at(work->module)(cell->getPort("\\A"));
 			SigBit y = sigmaps.at(work->module)(cell->getPort("\\Y"));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
+			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data == State::S1 ? "1" : "0";
 			string expr;
 
 			if (cell->type == "$_BUF_")  expr = a_expr;
@@ -403,8 +606,8 @@ struct SimplecWorker
 			SigBit b = sigmaps.at(work->module)(cell->getPort("\\B"));
 			SigBit y = sigmaps.at(work->module)(cell->getPort("\\Y"));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
+			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data == State::S1 ? "1" : "0";
+			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data == State::S1 ? "1" : "0";
 			string expr;
 
 			if (cell->type == "$_AND_")    expr = stringf("%s & %s",    a_expr.c_str(), b_expr.c_str());
@@ -431,9 +634,9 @@ struct SimplecWorker
 			SigBit c = sigmaps.at(work->module)(cell->getPort("\\C"));
 			SigBit y = sigmaps.at(work->module)(cell->getPort("\\Y"));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data ? "1" : "0";
+			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data == State::S1 ? "1" : "0";
+			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data == State::S1 ? "1" : "0";
+			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data == State::S1 ? "1" : "0";
 			string expr;
 
 			if (cell->type == "$_AOI3_") expr = stringf("!((%s & %s) | %s)", a_expr.c_str(), b_expr.c_str(), c_expr.c_str());
@@ -455,10 +658,10 @@ struct SimplecWorker
 			SigBit d = sigmaps.at(work->module)(cell->getPort("\\D"));
 			SigBit y = sigmaps.at(work->module)(cell->getPort("\\Y"));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data ? "1" : "0";
-			string d_expr = d.wire ? util_get_bit(work->prefix + cid(d.wire->name), d.wire->width, d.offset) : d.data ? "1" : "0";
+			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data == State::S1 ? "1" : "0";
+			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data == State::S1 ? "1" : "0";
+			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data == State::S1 ? "1" : "0";
+			string d_expr = d.wire ? util_get_bit(work->prefix + cid(d.wire->name), d.wire->width, d.offset) : d.data == State::S1 ? "1" : "0";
 			string expr;
 
 			if (cell->type == "$_AOI4_") expr = stringf("!((%s & %s) | (%s & %s))", a_expr.c_str(), b_expr.c_str(), c_expr.c_str(), d_expr.c_str());
@@ -479,9 +682,9 @@ struct SimplecWorker
 			SigBit s = sigmaps.at(work->module)(cell->getPort("\\S"));
 			SigBit y = sigmaps.at(work->module)(cell->getPort("\\Y"));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string s_expr = s.wire ? util_get_bit(work->prefix + cid(s.wire->name), s.wire->width, s.offset) : s.data ? "1" : "0";
+			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data == State::S1 ? "1" : "0";
+			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data == State::S1 ? "1" : "0";
+			string s_expr = s.wire ? util_get_bit(work->prefix + cid(s.wire->name), s.wire->width, s.offset) : s.data == State::S1 ? "1" : "0";
 
 			// casts to bool are a workaround for CBMC bug (https://github.com/diffblue/cbmc/issues/933)
 			string expr = stringf("%s ? %s(bool)%s : %s(bool)%s", s_expr.c_str(),
@@ -496,6 +699,96 @@ struct SimplecWorker
 			return;
 		}
 
+		if (cell->type.in("$not", "$pos", "$neg", "$logic_not", "$reduce_and", "$reduce_or", "$reduce_xor", "$reduce_xnor", "$reduce_bool",
+				"$and", "$or", "$xor", "$xnor", "$add", "$sub", "$mul", "$logic_and", "$logic_or",
+				"$eq", "$ne", "$eqx", "$nex", "$lt", "$le", "$ge", "$gt", "$shl", "$shr", "$sshl", "$sshr", "$mux", "$pmux"))
+		{
+			SigMap &sigmap = sigmaps.at(work->module);
+			bool is_binary = cell->hasPort("\\B") && !cell->type.in("$mux", "$pmux");
+
+			SigSpec a = sigmap(cell->getPort("\\A"));
+			SigSpec b = cell->hasPort("\\B") ? sigmap(cell->getPort("\\B")) : SigSpec();
+			SigSpec y = sigmap(cell->getPort("\\Y"));
+
+			if (GetSize(a) > 64 || GetSize(y) > 64 || (cell->type != "$pmux" && GetSize(b) > 64))
+				log_error("No C model for %s cells wider than 64 bits available (%s.%s).\n", log_id(cell->type),
+						log_id(work->module), log_id(cell));
+
+			bool a_signed = cell->hasParam("\\A_SIGNED") && cell->getParam("\\A_SIGNED").as_bool();
+			bool b_signed = cell->hasParam("\\B_SIGNED") && cell->getParam("\\B_SIGNED").as_bool();
+			bool is_signed = is_binary ? a_signed && b_signed : a_signed;
+
+			// operands extended to 64 bits, as yosys extends them to the width of the operation
+			string a_raw = word_expr(work, a), b_raw = cell->type != "$pmux" && !b.empty() ? word_expr(work, b) : string();
+			string a_expr = is_signed ? util_sext(a_raw, GetSize(a)) : a_raw;
+			string b_expr = is_signed ? util_sext(b_raw, GetSize(b)) : b_raw;
+			string expr;
+
+			if (cell->type == "$not")  expr = stringf("~%s", a_expr.c_str());
+			if (cell->type == "$pos")  expr = a_expr;
+			if (cell->type == "$neg")  expr = stringf("-%s", a_expr.c_str());
+
+			if (cell->type == "$logic_not")   expr = stringf("(uint64_t)(%s == 0)", a_raw.c_str());
+			if (cell->type == "$reduce_and")  expr = stringf("(uint64_t)(%s == 0x%llxULL)", a_raw.c_str(),
+					(unsigned long long)(GetSize(a) == 64 ? ~uint64_t(0) : (uint64_t(1) << GetSize(a)) - 1));
+			if (cell->type.in("$reduce_or", "$reduce_bool"))  expr = stringf("(uint64_t)(%s != 0)", a_raw.c_str());
+			if (cell->type == "$reduce_xor")  expr = stringf("(uint64_t)%s", util_parity(a_raw).c_str());
+			if (cell->type == "$reduce_xnor") expr = stringf("(uint64_t)!%s", util_parity(a_raw).c_str());
+
+			if (cell->type == "$and")  expr = stringf("%s & %s", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$or")   expr = stringf("%s | %s", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$xor")  expr = stringf("%s ^ %s", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$xnor") expr = stringf("~(%s ^ %s)", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$add")  expr = stringf("%s + %s", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$sub")  expr = stringf("%s - %s", a_expr.c_str(), b_expr.c_str());
+			if (cell->type == "$mul")  expr = stringf("%s * %s", a_expr.c_str(), b_expr.c_str());
+
+			if (cell->type == "$logic_and") expr = stringf("(uint64_t)(%s != 0 && %s != 0)", a_raw.c_str(), b_raw.c_str());
+			if (cell->type == "$logic_or")  expr = stringf("(uint64_t)(%s != 0 || %s != 0)", a_raw.c_str(), b_raw.c_str());
+
+			if (cell->type.in("$eq", "$eqx"))  expr = stringf("(uint64_t)(%s == %s)", a_expr.c_str(), b_expr.c_str());
+			if (cell->type.in("$ne", "$nex"))  expr = stringf("(uint64_t)(%s != %s)", a_expr.c_str(), b_expr.c_str());
+
+			if (cell->type.in("$lt", "$le", "$ge", "$gt")) {
+				const char *op = cell->type == "$lt" ? "<" : cell->type == "$le" ? "<=" : cell->type == "$ge" ? ">=" : ">";
+				if (is_signed)
+					expr = stringf("(uint64_t)((int64_t)%s %s (int64_t)%s)", a_expr.c_str(), op, b_expr.c_str());
+				else
+					expr = stringf("(uint64_t)(%s %s %s)", a_expr.c_str(), op, b_expr.c_str());
+			}
+
+			// the shift amount is always unsigned, the shifted value is extended to max(A_WIDTH, Y_WIDTH)
+			if (cell->type.in("$shl", "$shr", "$sshl", "$sshr"))
+			{
+				string sh_a = a_signed ? util_sext(a_raw, GetSize(a)) : a_raw;
+				int width = std::max(GetSize(a), GetSize(y));
+				uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+
+				if (cell->type.in("$shl", "$sshl"))
+					expr = stringf("(%s >= 64 ? (uint64_t)0 : %s << %s)", b_raw.c_str(), sh_a.c_str(), b_raw.c_str());
+				else if (cell->type == "$sshr" && a_signed)
+					expr = stringf("(uint64_t)((int64_t)%s >> (%s > 63 ? 63 : %s))", sh_a.c_str(), b_raw.c_str(), b_raw.c_str());
+				else
+					expr = stringf("(%s >= 64 ? (uint64_t)0 : (%s & 0x%llxULL) >> %s)", b_raw.c_str(), sh_a.c_str(),
+							(unsigned long long)mask, b_raw.c_str());
+			}
+
+			if (cell->type == "$mux")
+				expr = stringf("(%s ? %s : %s)", word_expr(work, sigmap(cell->getPort("\\S"))).c_str(), b_raw.c_str(), a_raw.c_str());
+
+			// $pmux selects the first B slice with an active select bit (the result is undefined if more than one is active)
+			if (cell->type == "$pmux") {
+				SigSpec s = sigmap(cell->getPort("\\S"));
+				expr = a_raw;
+				for (int i = GetSize(s)-1; i >= 0; i--)
+					expr = stringf("(%s ? %s : %s)", word_expr(work, s[i]).c_str(),
+							word_expr(work, b.extract(i*GetSize(y), GetSize(y))).c_str(), expr.c_str());
+			}
+
+			set_word(work, y, expr, stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
+			return;
+		}
+
 		log_error("No C model for %s available at the moment (FIXME).\n", log_id(cell->type));
 	}
 
@@ -560,8 +853,8 @@ struct SimplecWorker
 											work->log_prefix.c_str(), log_id(std::get<0>(port)), log_id(child_bit.wire), child_bit.offset);
 							} else {
 								if (verbose)
-									log("      Marking cell %s.%s (via %s.%s[%d]).\n", work->log_prefix.c_str(), log_id(std::get<0>(port)),
-											work->log_prefix.c_str(), log_id(bit.wire), bit.offset);
+									log("      Marking cell %s.%s (via %s.%s).\n", work->log_prefix.c_str(), log_id(std::get<0>(port)),
+											work->log_prefix.c_str(), log_signal(bit));
 								work->set_dirty(std::get<0>(port));
 							}
 						}
@@ -573,7 +866,7 @@ struct SimplecWorker
 				{
 					Cell *cell = nullptr;
 					for (auto c : work->dirty_cells)
-						if (cell == nullptr || topoidx.at(cell) < topoidx.at(c))
+						if (cell == nullptr || topoidx.at(c) < topoidx.at(cell))
 							cell = c;
 
 					string hiername = work->log_prefix + "." + log_id(cell);
@@ -662,7 +955,7 @@ struct SimplecWorker
 				for (int i = 0; i < GetSize(sig); i++)
 					if (val[i] == State::S0 || val[i] == State::S1) {
 						SigBit bit = sig[i];
-						preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, val == State::S1 ? "true" : "false"));
+						preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, val[i] == State::S1 ? "true" : "false"));
 						work->set_dirty(bit);
 					}
 			}
@@ -707,9 +1000,70 @@ struct SimplecWorker
 		make_func(work, cid(work->module->name) + "_eval", preamble);
 	}
 
-	void make_tick_func(HierDirtyFlags* /* work */)
+	void eval_tick(HierDirtyFlags *work, vector<string> &preamble, vector<string> &updates, State &clk_polarity)
 	{
-		// FIXME
+		Module *module = work->module;
+
+		for (Cell *cell : module->cells())
+		{
+			if (!is_dff(cell))
+				continue;
+
+			State polarity = cell->type == "$_DFF_N_" ? State::S0 : cell->type == "$_DFF_P_" ? State::S1 :
+					cell->getParam("\\CLK_POLARITY").as_bool() ? State::S1 : State::S0;
+
+			// all flip-flops are updated by the same _tick() call, which is only
+			// correct if they all trigger on the same clock edge
+			if (clk_polarity == State::Sx)
+				clk_polarity = polarity;
+			else if (clk_polarity != polarity)
+				log_error("Design contains flip-flops on both clock edges (e.g. %s.%s), which is not supported by write_simplec.\n",
+						log_id(module), log_id(cell));
+
+			SigSpec d = sigmaps.at(module)(cell->getPort("\\D"));
+			SigSpec q = sigmaps.at(module)(cell->getPort("\\Q"));
+
+			if (GetSize(q) > 64)
+				log_error("No C model for %s cells wider than 64 bits available (%s.%s).\n", log_id(cell->type),
+						log_id(module), log_id(cell));
+
+			string tmp_name = stringf("next_q_%d", GetSize(preamble));
+
+			// sample all D inputs before updating any Q output
+			if (GetSize(d) == 1) {
+				string d_expr = d[0].wire ? util_get_bit(work->prefix + cid(d[0].wire->name), d[0].wire->width, d[0].offset) :
+						d[0].data == State::S1 ? "1" : "0";
+				preamble.push_back(stringf("  bool %s = %s; // %s (%s)", tmp_name.c_str(), d_expr.c_str(), log_id(cell), log_id(cell->type)));
+			} else {
+				preamble.push_back(stringf("  uint64_t %s = %s; // %s (%s)", tmp_name.c_str(), word_expr(work, d).c_str(), log_id(cell), log_id(cell->type)));
+			}
+
+			int pos = 0;
+			for (auto &chunk : q.chunks()) {
+				log_assert(chunk.wire);
+				if (chunk.width == 1 && GetSize(q) == 1)
+					updates.push_back(util_set_bit(work->prefix + cid(chunk.wire->name), chunk.wire->width, chunk.offset, tmp_name));
+				else
+					updates.push_back(util_set_bits(work->prefix + cid(chunk.wire->name), chunk.wire->width, chunk.offset, chunk.width,
+							pos ? stringf("%s >> %d", tmp_name.c_str(), pos) : tmp_name));
+				pos += chunk.width;
+			}
+
+			for (auto bit : q)
+				work->set_dirty(bit);
+		}
+
+		for (auto &child : work->children)
+			eval_tick(child.second, preamble, updates, clk_polarity);
+	}
+
+	void make_tick_func(HierDirtyFlags *work)
+	{
+		vector<string> preamble, updates;
+		State clk_polarity = State::Sx;
+		eval_tick(work, preamble, updates, clk_polarity);
+		preamble.insert(preamble.end(), updates.begin(), updates.end());
+		make_func(work, cid(work->module->name) + "_tick", preamble);
 	}
 
 	void run(Module *mod)
@@ -760,6 +1114,20 @@ struct SimplecBackend : public Backend {
 		log("    -i8, -i16, -i32, -i64\n");
 		log("        set the maximum integer bit width to use in the generated code.\n");
 		log("\n");
+		log("For the top module <top> the functions <top>_init(), <top>_eval() and\n");
+		log("<top>_tick() are generated. <top>_eval() must be called after changing inputs.\n");
+		log("<top>_tick() updates all $dff, $_DFF_N_ and $_DFF_P_ flip-flops in the design\n");
+		log("at once (i.e. the design is treated as having a single clock domain and the\n");
+		log("clock inputs of the flip-flops are ignored) and then propagates the changes.\n");
+		log("Designs with flip-flops on both clock edges are rejected.\n");
+		log("\n");
+		log("Besides the simple gate cells ($_AND_, $_MUX_, etc.), the word-level cells\n");
+		log("$not, $pos, $neg, $and, $or, $xor, $xnor, $add, $sub, $mul, $shl, $shr, $sshl,\n");
+		log("$sshr, $reduce_*, $logic_*, $eq, $ne, $eqx, $nex, $lt, $le, $ge, $gt, $mux and\n");
+		log("$pmux are supported with up to 64 bits per port. They are evaluated on\n");
+		log("uint64_t words. The cells of a module are evaluated in topological order.\n");
+		log("Memories must be mapped to flip-flops (e.g. with 'memory_map') first.\n");
+		log("\n");
 		log("THIS COMMAND IS UNDER CONSTRUCTION\n");
 		log("\n");
 	}
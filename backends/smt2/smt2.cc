@@ -22,11 +22,24 @@
 #include "kernel/sigtools.h"
 #include "kernel/celltypes.h"
 #include "kernel/log.h"
+#include "backends/ilang/ilang_backend.h"
+#include "libs/sha1/sha1.h"
 #include <string>
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+struct Smt2CacheEntry
+{
+	std::string text, id;
+	int stbv_width;
+	dict<IdString, pair<bool, bool>> clk_cache;
+};
+
+// SMT-LIBv2 code for modules from earlier write_smt2 calls, indexed by a hash
+// of the module, its submodules and the write_smt2 options (see "smt2.cache")
+static dict<std::string, Smt2CacheEntry> smt2_module_cache;
+
 struct Smt2Worker
 {
 	CellTypes ct;
@@ -1369,6 +1382,13 @@ struct Smt2Backend : public Backend {
 		log("        use the given template file. the line containing only the token '%%%%'\n");
 		log("        is replaced with the regular output of this command.\n");
 		log("\n");
+		log("When the scratchpad variable 'smt2.cache' is set to true, the SMT-LIBv2 code\n");
+		log("generated for each module is kept in memory, indexed by a hash of the module,\n");
+		log("its submodules and the options above. Later write_smt2 calls re-use that code\n");
+		log("for all modules that have not changed, for example when only the properties\n");
+		log("in the top module are modified between runs. The cache is cleared by the\n");
+		log("next write_smt2 call after the variable is unset.\n");
+		log("\n");
 		log("[1] For more information on SMT-LIBv2 visit http://smt-lib.org/ or read David\n");
 		log("R. Cok's tutorial: http://www.grammatech.com/resources/smt/SMTLIBTutorial.pdf\n");
 		log("\n");
@@ -1418,6 +1438,10 @@ struct Smt2Backend : public Backend {
 		log("from non-zero to zero in the test design.\n");
 		log("\n");
 	}
+	void on_shutdown() YS_OVERRIDE
+	{
+		smt2_module_cache.clear();
+	}
 	void execute(std::ostream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
 		std::ifstream template_f;
@@ -1542,16 +1566,74 @@ struct Smt2Backend : public Backend {
 				log_error("Forall-exists problems are only supported in -stbv or -stdt mode.\n");
 		}
 
+		if (!design->scratchpad_get_bool("smt2.cache"))
+			smt2_module_cache.clear();
+
+		bool use_cache = design->scratchpad_get_bool("smt2.cache") && !verbose;
+		std::string cache_options = stringf("%d %d %d %d %d %d", bvmode, memmode, wiresmode, statebv, statedt, forallmode);
+		dict<Module*, std::string> module_hashes;
+
 		for (auto module : sorted_modules)
 		{
-			if (module->get_blackbox_attribute() || module->has_memories_warn() || module->has_processes_warn())
+			if (module->get_blackbox_attribute() || module->has_memories_warn() || module->has_processes_warn()) {
+				// no code is generated for these modules, so only their
+				// interface matters for the code of the parent modules
+				if (use_cache) {
+					std::string hash = module->name.str();
+					for (auto port : module->ports) {
+						Wire *wire = module->wire(port);
+						hash += stringf(" %s:%d:%d:%d", log_id(port), wire->width, wire->port_input, wire->port_output);
+					}
+					module_hashes[module] = hash;
+				}
 				continue;
+			}
+
+			std::string hash;
+			if (use_cache) {
+				std::set<std::string> submodule_hashes;
+				for (auto cell : module->cells())
+					if (design->module(cell->type) != nullptr)
+						submodule_hashes.insert(module_hashes.at(design->module(cell->type)));
+				std::stringstream buf;
+				buf << cache_options << "\n";
+				for (auto &it : submodule_hashes)
+					buf << it << "\n";
+				ILANG_BACKEND::dump_module(buf, "", module, design, false);
+				hash = sha1(buf.str());
+				module_hashes[module] = hash;
+			}
 
 			log("Creating SMT-LIBv2 representation of module %s.\n", log_id(module));
 
+			if (use_cache && smt2_module_cache.count(hash)) {
+				const Smt2CacheEntry &entry = smt2_module_cache.at(hash);
+				log("Using SMT-LIBv2 code cached from an earlier write_smt2 call.\n");
+				*f << entry.text;
+				if (statebv)
+					mod_stbv_width[module->name] = entry.stbv_width;
+				if (!entry.clk_cache.empty())
+					mod_clk_cache[module->name] = entry.clk_cache;
+				if (module == topmod)
+					topmod_id = entry.id;
+				continue;
+			}
+
 			Smt2Worker worker(module, bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode, mod_stbv_width, mod_clk_cache);
 			worker.run();
-			worker.write(*f);
+
+			if (use_cache) {
+				std::stringstream buf;
+				worker.write(buf);
+				Smt2CacheEntry &entry = smt2_module_cache[hash];
+				entry.text = buf.str();
+				entry.id = worker.get_id(module);
+				entry.stbv_width = statebv ? mod_stbv_width.at(module->name) : 0;
+				if (mod_clk_cache.count(module->name))
+					entry.clk_cache = mod_clk_cache.at(module->name);
+				*f << entry.text;
+			} else
+				worker.write(*f);
 
 			if (module == topmod)
 				topmod_id = worker.get_id(module);
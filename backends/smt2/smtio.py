@@ -435,7 +435,9 @@ class SmtIo:
                         self.p_write(stmt + "\n", True)
                     self.smt2cache[-1].append(stmt)
             else:
-                self.p_write(stmt + "\n", True)
+                # only flush when the solver is expected to respond
+                flush = not stmt.startswith(("(declare-", "(define-", "(assert", "(push", "(pop"))
+                self.p_write(stmt + "\n", flush)
 
     def info(self, stmt):
         if not stmt.startswith("; yosys-smt2-"):
@@ -715,36 +717,29 @@ class SmtIo:
         return result
 
     def parse(self, stmt):
-        def worker(stmt):
-            if stmt[0] == '(':
+        # works on an index into stmt instead of slices of it, so that
+        # parsing large statements is not quadratic in their length
+        def worker(cursor):
+            while stmt[cursor] in " \t\r\n":
+                cursor += 1
+
+            if stmt[cursor] == '(':
                 expr = []
-                cursor = 1
+                cursor += 1
                 while stmt[cursor] != ')':
-                    el, le = worker(stmt[cursor:])
+                    el, cursor = worker(cursor)
                     expr.append(el)
-                    cursor += le
-                return expr, cursor+1
-
-            if stmt[0] == '|':
-                expr = "|"
-                cursor = 1
-                while stmt[cursor] != '|':
-                    expr += stmt[cursor]
-                    cursor += 1
-                expr += "|"
                 return expr, cursor+1
 
-            if stmt[0] in [" ", "\t", "\r", "\n"]:
-                el, le = worker(stmt[1:])
-                return el, le+1
+            if stmt[cursor] == '|':
+                end = stmt.index('|', cursor+1)
+                return stmt[cursor:end+1], end+1
 
-            expr = ""
-            cursor = 0
-            while stmt[cursor] not in ["(", ")", "|", " ", "\t", "\r", "\n"]:
-                expr += stmt[cursor]
+            start = cursor
+            while stmt[cursor] not in "()| \t\r\n":
                 cursor += 1
-            return expr, cursor
-        return worker(stmt)[0]
+            return stmt[start:cursor], cursor
+        return worker(0)[0]
 
     def unparse(self, stmt):
         if isinstance(stmt, list):
@@ -324,6 +324,18 @@ static uint32_t parse_xaiger_literal(std::istream &f)
 }
 
 RTLIL::Wire* AigerReader::createWireIfNotExists(RTLIL::Module *module, unsigned literal)
+{
+	// fast path: avoid building and looking up the wire name for literals we have already seen
+	if (literal < literal_wires.size() && literal_wires[literal] != nullptr)
+		return literal_wires[literal];
+
+	RTLIL::Wire *wire = createWireIfNotExistsByName(module, literal);
+	if (literal < literal_wires.size())
+		literal_wires[literal] = wire;
+	return wire;
+}
+
+RTLIL::Wire* AigerReader::createWireIfNotExistsByName(RTLIL::Module *module, unsigned literal)
 {
 	const unsigned variable = literal >> 1;
 	const bool invert = literal & 1;
@@ -351,6 +363,16 @@ RTLIL::Wire* AigerReader::createWireIfNotExists(RTLIL::Module *module, unsigned
 	return wire;
 }
 
+// pre-size the module's wire and cell dicts and the literal->wire map from the
+// header counts, so that large AIGs do not cause repeated rehashing
+void AigerReader::reserve_module_storage()
+{
+	module->wires_.reserve(2*size_t(I) + 2*size_t(L) + size_t(O) + size_t(A));
+	module->cells_.reserve(size_t(L) + size_t(A));
+	literal_wires.clear();
+	literal_wires.resize(2*(size_t(M)+1), nullptr);
+}
+
 void AigerReader::parse_xaiger()
 {
 	std::string header;
@@ -499,6 +521,8 @@ void AigerReader::parse_xaiger()
 
 void AigerReader::parse_aiger_ascii()
 {
+	reserve_module_storage();
+
 	std::string line;
 	std::stringstream ss;
 
@@ -618,17 +642,25 @@ void AigerReader::parse_aiger_ascii()
 	std::getline(f, line); // Ignore up to start of next line
 }
 
-static unsigned parse_next_delta_literal(std::istream &f, unsigned ref)
+static unsigned parse_next_delta_literal(std::streambuf *sb, unsigned ref)
 {
 	unsigned x = 0, i = 0;
-	unsigned char ch;
-	while ((ch = f.get()) & 0x80)
+	int ch;
+	while (1) {
+		ch = sb->sbumpc();
+		if (ch == EOF)
+			log_error("Unexpected EOF in binary AND section!\n");
+		if (!(ch & 0x80))
+			break;
 		x |= (ch & 0x7f) << (7 * i++);
+	}
 	return ref - (x | (ch << (7 * i)));
 }
 
 void AigerReader::parse_aiger_binary()
 {
+	reserve_module_storage();
+
 	unsigned l1, l2, l3;
 	std::string line;
 
@@ -729,10 +761,11 @@ void AigerReader::parse_aiger_binary()
 		std::getline(f, line); // Ignore up to start of next line
 
 	// Parse AND
+	std::streambuf *sb = f.rdbuf();
 	l1 = (I+L+1) << 1;
 	for (unsigned i = 0; i < A; ++i, ++line_count, l1 += 2) {
-		l2 = parse_next_delta_literal(f, l1);
-		l3 = parse_next_delta_literal(f, l2);
+		l2 = parse_next_delta_literal(sb, l1);
+		l3 = parse_next_delta_literal(sb, l2);
 
 		log_debug2("%d %d %d is an AND\n", l1, l2, l3);
 		log_assert(!(l1 & 1));
@@ -29,6 +29,7 @@
 
 #include "kernel/yosys.h"
 #include "libs/sha1/sha1.h"
+#include "backends/ilang/ilang_backend.h"
 #include "ast.h"
 
 YOSYS_NAMESPACE_BEGIN
@@ -1383,6 +1384,166 @@ void AstModule::reprocess_module(RTLIL::Design *design, dict<RTLIL::IdString, RT
 	mod->set_bool_attribute("\\interfaces_replaced_in_module");
 }
 
+// serialize everything in an AST that can influence the generated RTLIL (used as key for the derive cache)
+static void derive_cache_fingerprint(const AstNode *node, std::string &buf)
+{
+	buf += stringf("(%s %d:%s", type2str(node->type).c_str(), GetSize(node->str), node->str.c_str());
+	for (auto bit : node->bits)
+		buf += stringf("%d", int(bit));
+	buf += stringf(" %d%d%d%d%d%d%d%d%d%d%d%d%d %d %d %d %u %.17g", node->is_input, node->is_output, node->is_reg, node->is_logic,
+			node->is_signed, node->is_string, node->is_wand, node->is_wor, node->range_valid, node->range_swapped,
+			node->was_checked, node->is_unsized, node->is_custom_type, node->port_id, node->range_left, node->range_right,
+			(unsigned int)node->integer, node->realvalue);
+	for (auto dim : node->multirange_dimensions)
+		buf += stringf(" %d", dim);
+	buf += stringf(" %s:%d", node->filename.c_str(), node->linenum);
+	for (auto &attr : node->attributes) {
+		buf += stringf(" @%s=", attr.first.c_str());
+		derive_cache_fingerprint(attr.second, buf);
+	}
+	for (auto child : node->children)
+		derive_cache_fingerprint(child, buf);
+	buf += ")";
+}
+
+// the derive cache is enabled by setting the scratchpad variable "ast.derive_cache" to a directory.
+// returns the name of the cache file for the derived module, or an empty string if the cache is disabled.
+static std::string derive_cache_filename(RTLIL::Design *design, const AstModule *module, const AstNode *new_ast)
+{
+	std::string cache_dir = design->scratchpad_get_string("ast.derive_cache");
+	if (cache_dir.empty())
+		return std::string();
+
+	std::string key = stringf("%s\n%d%d%d%d%d%d%d%d%d%d%d\n", yosys_version_str, module->nolatches, module->nomeminit,
+			module->nomem2reg, module->mem2reg, module->noblackbox, module->lib, module->nowb, module->noopt,
+			module->icells, module->pwires, module->autowire);
+	derive_cache_fingerprint(new_ast, key);
+
+	return cache_dir + "/" + sha1(key) + ".il";
+}
+
+// make sure that auto-generated names created after loading a module from the cache
+// (of the form "$...$<autoidx>") can not collide with the names in the loaded module
+static void derive_cache_bump_autoidx(IdString name)
+{
+	const std::string &str = name.str();
+	if (str[0] != '$')
+		return;
+	size_t pos = str.rfind('$');
+	if (pos == 0 || pos+1 == str.size() || pos+10 < str.size())
+		return;
+	for (size_t i = pos+1; i < str.size(); i++)
+		if (str[i] < '0' || str[i] > '9')
+			return;
+	autoidx = std::max(autoidx, atoi(str.c_str() + pos + 1) + 1);
+}
+
+// load a derived module from the cache. new_ast is the (unsimplified) AST the module would be derived from.
+// cache files start with a checksum of their contents. a file that is truncated or corrupted is treated
+// like a cache miss (the ilang frontend would abort on a syntax error).
+static bool derive_cache_load(RTLIL::Design *design, const std::string &cache_file, const AstModule *module, AstNode *new_ast)
+{
+	std::ifstream f;
+	f.open(cache_file.c_str());
+	if (f.fail())
+		return false;
+
+	std::stringstream buffer;
+	buffer << f.rdbuf();
+	std::string content = buffer.str();
+
+	size_t header_end = content.find('\n');
+	if (header_end == std::string::npos || content.compare(0, header_end, "# " + sha1(content.substr(header_end+1))) != 0) {
+		log_warning("Derive cache file `%s' is corrupted, ignoring it.\n", cache_file.c_str());
+		return false;
+	}
+
+	RTLIL::Design *cache_design = new RTLIL::Design;
+	{
+		LogMakeDebugHdl debug_hdl(true);
+		std::istringstream in(content);
+		Frontend::frontend_call(cache_design, &in, cache_file, "read_ilang");
+	}
+
+	RTLIL::Module *cached_mod = cache_design->module(new_ast->str);
+	if (cached_mod == nullptr) {
+		log_warning("Derive cache file `%s' does not contain module `%s', ignoring it.\n", cache_file.c_str(), new_ast->str.c_str());
+		delete cache_design;
+		return false;
+	}
+
+	log("Loading RTLIL representation for module `%s' from derive cache.\n", new_ast->str.c_str());
+
+	for (auto wire : cached_mod->wires())
+		derive_cache_bump_autoidx(wire->name);
+	for (auto cell : cached_mod->cells())
+		derive_cache_bump_autoidx(cell->name);
+	for (auto &it : cached_mod->memories)
+		derive_cache_bump_autoidx(it.first);
+	for (auto &it : cached_mod->processes)
+		derive_cache_bump_autoidx(it.first);
+
+	AstModule *new_mod = new AstModule;
+	new_mod->name = cached_mod->name;
+	cached_mod->cloneInto(new_mod);
+	new_mod->ast = new_ast->clone();
+	new_mod->nolatches = module->nolatches;
+	new_mod->nomeminit = module->nomeminit;
+	new_mod->nomem2reg = module->nomem2reg;
+	new_mod->mem2reg = module->mem2reg;
+	new_mod->noblackbox = module->noblackbox;
+	new_mod->lib = module->lib;
+	new_mod->nowb = module->nowb;
+	new_mod->noopt = module->noopt;
+	new_mod->icells = module->icells;
+	new_mod->pwires = module->pwires;
+	new_mod->autowire = module->autowire;
+	design->add(new_mod);
+
+	delete cache_design;
+	return true;
+}
+
+// store a freshly derived module in the cache. modules that take part in SystemVerilog interface
+// handling are never cached, because the hierarchy pass may need to re-derive them from the AST.
+static void derive_cache_store(const std::string &cache_file, RTLIL::Module *mod)
+{
+	if (mod->get_bool_attribute("\\is_interface"))
+		return;
+	for (auto wire : mod->wires())
+		if (wire->get_bool_attribute("\\is_interface"))
+			return;
+	for (auto cell : mod->cells())
+		if (cell->get_bool_attribute("\\is_interface"))
+			return;
+
+	// write to a temporary file first, so that concurrent runs never see partial cache entries
+	std::string temp_file = make_temp_file(cache_file + "_XXXXXX");
+	std::ofstream f;
+	f.open(temp_file.c_str(), std::ofstream::trunc);
+	if (f.fail()) {
+		log_warning("Can't open derive cache file `%s' for writing: %s\n", temp_file.c_str(), strerror(errno));
+		return;
+	}
+	std::stringstream buffer;
+	ILANG_BACKEND::dump_module(buffer, "", mod, mod->design, false);
+	f << "# " << sha1(buffer.str()) << "\n" << buffer.str();
+	f.close();
+
+	if (f.fail() || rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+		log_warning("Failed to write derive cache file `%s'.\n", cache_file.c_str());
+		remove(temp_file.c_str());
+	}
+}
+
+// modules derived from a module read with "read_verilog -incremental" inherit its source hash, so that
+// the source file is still recognized as unchanged after the hierarchy pass has run
+static void derive_copy_src_sha1(const AstModule *module, RTLIL::Module *new_mod)
+{
+	if (module->attributes.count(ID(src_sha1)))
+		new_mod->attributes[ID(src_sha1)] = module->attributes.at(ID(src_sha1));
+}
+
 // create a new parametric module (when needed) and return the name of the generated module - WITH support for interfaces
 // This method is used to explode the interface when the interface is a port of the module (not instantiated inside)
 RTLIL::IdString AstModule::derive(RTLIL::Design *design, dict<RTLIL::IdString, RTLIL::Const> parameters, dict<RTLIL::IdString, RTLIL::Module*> interfaces, dict<RTLIL::IdString, RTLIL::IdString> modports, bool /*mayfail*/)
@@ -1414,6 +1575,16 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, dict<RTLIL::IdString, R
 		modname = new_modname;
 		new_ast->str = modname;
 
+		std::string cache_file;
+		if (!has_interfaces) {
+			cache_file = derive_cache_filename(design, this, new_ast);
+			if (!cache_file.empty() && derive_cache_load(design, cache_file, this, new_ast)) {
+				derive_copy_src_sha1(this, design->module(modname));
+				delete new_ast;
+				return modname;
+			}
+		}
+
 		// Iterate over all interfaces which are ports in this module:
 		for(auto &intf : interfaces) {
 			RTLIL::Module * intfmodule = intf.second;
@@ -1455,6 +1626,10 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, dict<RTLIL::IdString, R
 			mod->set_bool_attribute("\\interfaces_replaced_in_module");
 		}
 
+		if (!cache_file.empty())
+			derive_cache_store(cache_file, mod);
+		derive_copy_src_sha1(this, mod);
+
 	} else {
 		log("Found cached RTLIL representation for module `%s'.\n", modname.c_str());
 	}
@@ -1471,8 +1646,14 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, dict<RTLIL::IdString, R
 
 	if (!design->has(modname)) {
 		new_ast->str = modname;
-		design->add(process_module(new_ast, false));
-		design->module(modname)->check();
+		std::string cache_file = derive_cache_filename(design, this, new_ast);
+		if (cache_file.empty() || !derive_cache_load(design, cache_file, this, new_ast)) {
+			design->add(process_module(new_ast, false));
+			design->module(modname)->check();
+			if (!cache_file.empty())
+				derive_cache_store(cache_file, design->module(modname));
+		}
+		derive_copy_src_sha1(this, design->module(modname));
 	} else {
 		log("Found cached RTLIL representation for module `%s'.\n", modname.c_str());
 	}
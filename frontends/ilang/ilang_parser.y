@@ -240,19 +240,21 @@ cell_stmt:
 
 cell_body:
 	cell_body TOK_PARAMETER TOK_ID constant EOL {
-		current_cell->parameters[$3] = *$4;
+		current_cell->parameters[$3] = std::move(*$4);
 		free($3);
 		delete $4;
 	} |
 	cell_body TOK_PARAMETER TOK_SIGNED TOK_ID constant EOL {
-		current_cell->parameters[$4] = *$5;
-		current_cell->parameters[$4].flags |= RTLIL::CONST_FLAG_SIGNED;
+		RTLIL::Const &param = current_cell->parameters[$4];
+		param = std::move(*$5);
+		param.flags |= RTLIL::CONST_FLAG_SIGNED;
 		free($4);
 		delete $5;
 	} |
 	cell_body TOK_PARAMETER TOK_REAL TOK_ID constant EOL {
-		current_cell->parameters[$4] = *$5;
-		current_cell->parameters[$4].flags |= RTLIL::CONST_FLAG_REAL;
+		RTLIL::Const &param = current_cell->parameters[$4];
+		param = std::move(*$5);
+		param.flags |= RTLIL::CONST_FLAG_REAL;
 		free($4);
 		delete $5;
 	} |
@@ -382,10 +384,13 @@ constant:
 	TOK_VALUE {
 		char *ep;
 		int width = strtol($1, &ep, 10);
-		std::list<RTLIL::State> bits;
-		while (*(++ep) != 0) {
+		char *bits_begin = ep + 1, *bits_end = bits_begin + strlen(bits_begin);
+		$$ = new RTLIL::Const;
+		$$->bits.reserve(std::max(width, 1));
+		// the value is written MSB first, but Const::bits is LSB first
+		for (char *p = bits_end; p != bits_begin && (int)$$->bits.size() < width; p--) {
 			RTLIL::State bit = RTLIL::Sx;
-			switch (*ep) {
+			switch (p[-1]) {
 			case '0': bit = RTLIL::S0; break;
 			case '1': bit = RTLIL::S1; break;
 			case 'x': bit = RTLIL::Sx; break;
@@ -393,21 +398,18 @@ constant:
 			case '-': bit = RTLIL::Sa; break;
 			case 'm': bit = RTLIL::Sm; break;
 			}
-			bits.push_front(bit);
+			$$->bits.push_back(bit);
 		}
-		if (bits.size() == 0)
-			bits.push_back(RTLIL::Sx);
-		while ((int)bits.size() < width) {
-			RTLIL::State bit = bits.back();
+		if (bits_begin == bits_end)
+			$$->bits.push_back(RTLIL::Sx);
+		while ((int)$$->bits.size() < width) {
+			RTLIL::State bit = $$->bits.back();
 			if (bit == RTLIL::S1)
 				bit = RTLIL::S0;
-			bits.push_back(bit);
+			$$->bits.push_back(bit);
 		}
-		while ((int)bits.size() > width)
-			bits.pop_back();
-		$$ = new RTLIL::Const;
-		for (auto it = bits.begin(); it != bits.end(); it++)
-			$$->bits.push_back(*it);
+		if ((int)$$->bits.size() > width)
+			$$->bits.resize(std::max(width, 0));
 		free($1);
 	} |
 	TOK_INT {
@@ -424,9 +426,10 @@ sigspec:
 		delete $1;
 	} |
 	TOK_ID {
-		if (current_module->wires_.count($1) == 0)
+		auto it = current_module->wires_.find($1);
+		if (it == current_module->wires_.end())
 			rtlil_frontend_ilang_yyerror(stringf("ilang error: wire %s not found", $1).c_str());
-		$$ = new RTLIL::SigSpec(current_module->wires_[$1]);
+		$$ = new RTLIL::SigSpec(it->second);
 		free($1);
 	} |
 	sigspec '[' TOK_INT ']' {
@@ -447,7 +450,7 @@ sigspec:
 
 sigspec_list_reversed:
 	sigspec_list_reversed sigspec {
-		$$->push_back(*$2);
+		$$->push_back(std::move(*$2));
 		delete $2;
 	} |
 	/* empty */ {
@@ -456,8 +459,11 @@ sigspec_list_reversed:
 
 sigspec_list: sigspec_list_reversed {
 		$$ = new RTLIL::SigSpec;
-		for (auto it = $1->rbegin(); it != $1->rend(); it++)
-			$$->append(*it);
+		if ($1->size() == 1)
+			*$$ = std::move($1->front());
+		else
+			for (auto it = $1->rbegin(); it != $1->rend(); it++)
+				$$->append(*it);
 		delete $1;
 	};
 
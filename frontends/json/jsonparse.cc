@@ -527,6 +527,112 @@ void json_import(Design *design, string &modname, JsonNode *node)
 	}
 }
 
+// skip whitespace and the given separator characters and return the next character
+static int json_next_char(std::istream &f, const char *separators)
+{
+	while (1)
+	{
+		int ch = f.get();
+
+		if (ch == EOF)
+			log_error("Unexpected EOF in JSON file.\n");
+
+		if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+			continue;
+
+		if (ch != 0 && strchr(separators, ch) != nullptr)
+			continue;
+
+		return ch;
+	}
+}
+
+// read the key of the next entry of a JSON dict, returns false at the end of the dict
+static bool json_next_dict_key(std::istream &f, string &key)
+{
+	if (json_next_char(f, ",") == '}')
+		return false;
+	f.unget();
+
+	JsonNode key_node(f);
+
+	if (key_node.type != 'S')
+		log_error("Unexpected non-string key in JSON dict.\n");
+
+	json_next_char(f, ":");
+	f.unget();
+
+	key = key_node.data_string;
+	return true;
+}
+
+// Parse the top-level dict of a JSON file. Modules are imported as soon as their
+// dict has been read and are freed right away, so that only the JsonNode tree of
+// one module needs to be kept in memory at any time.
+//
+// The result is the same as when building a JsonNode tree for the whole file: for
+// duplicate keys the last entry wins, and the imported modules end up in the same
+// order in the design.
+static void json_parse_design(Design *design, std::istream &f)
+{
+	if (json_next_char(f, "") != '{')
+		log_error("JSON root node is not a dictionary.\n");
+
+	// module names in the order of their first occurrence
+	vector<string> modnames;
+	dict<string, Module*> imported;
+
+	string key;
+	while (json_next_dict_key(f, key))
+	{
+		if (key != "modules") {
+			JsonNode ignored_node(f);
+			continue;
+		}
+
+		// a later "modules" entry replaces an earlier one
+		for (auto &it : imported)
+			design->remove(it.second);
+		modnames.clear();
+		imported.clear();
+
+		if (json_next_char(f, "") != '{')
+			log_error("JSON modules node is not a dictionary.\n");
+
+		string modname;
+		while (json_next_dict_key(f, modname)) {
+			JsonNode module_node(f);
+			if (imported.count(modname))
+				design->remove(imported.at(modname));
+			else
+				modnames.push_back(modname);
+			json_import(design, modname, &module_node);
+			imported[modname] = design->module(RTLIL::escape_id(modname));
+		}
+	}
+
+	if (GetSize(modnames) < 2)
+		return;
+
+	// Design::modules_ iterates in reverse order of insertion, and the modules from a
+	// JsonNode tree used to be added in reverse file order. Re-add the imported modules
+	// in that order, after the modules that were already in the design.
+	pool<Module*> imported_modules;
+	for (auto &it : imported)
+		imported_modules.insert(it.second);
+
+	vector<Module*> old_modules;
+	for (auto &it : design->modules_)
+		if (!imported_modules.count(it.second))
+			old_modules.push_back(it.second);
+
+	design->modules_.clear();
+	for (auto it = old_modules.rbegin(); it != old_modules.rend(); ++it)
+		design->modules_[(*it)->name] = *it;
+	for (auto it = modnames.rbegin(); it != modnames.rend(); ++it)
+		design->modules_[imported.at(*it)->name] = imported.at(*it);
+}
+
 struct JsonFrontend : public Frontend {
 	JsonFrontend() : Frontend("json", "read JSON file") { }
 	void help() YS_OVERRIDE
@@ -554,21 +660,7 @@ struct JsonFrontend : public Frontend {
 		}
 		extra_args(f, filename, args, argidx);
 
-		JsonNode root(*f);
-
-		if (root.type != 'D')
-			log_error("JSON root node is not a dictionary.\n");
-
-		if (root.data_dict.count("modules") != 0)
-		{
-			JsonNode *modules = root.data_dict.at("modules");
-
-			if (modules->type != 'D')
-				log_error("JSON modules node is not a dictionary.\n");
-
-			for (auto &it : modules->data_dict)
-				json_import(design, it.first, it.second);
-		}
+		json_parse_design(design, *f);
 	}
 } JsonFrontend;
 
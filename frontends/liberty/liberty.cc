@@ -485,6 +485,12 @@ struct LibertyFrontend : public Frontend {
 		log("    -setattr <attribute_name>\n");
 		log("        set the specified attribute (to the value 1) on all loaded modules\n");
 		log("\n");
+		log("    -cell <name_pattern>\n");
+		log("        only load cells matching the given name (wildcards are supported).\n");
+		log("        this option can be used multiple times. the bodies of all other cells\n");
+		log("        are skipped without parsing them, which speeds up reading large\n");
+		log("        libraries when only a few cells are needed.\n");
+		log("\n");
 	}
 	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
@@ -495,6 +501,7 @@ struct LibertyFrontend : public Frontend {
 		bool flag_ignore_miss_dir  = false;
 		bool flag_ignore_miss_data_latch = false;
 		std::vector<std::string> attributes;
+		std::vector<std::string> cell_patterns;
 
 		log_header(design, "Executing Liberty frontend.\n");
 
@@ -531,11 +538,24 @@ struct LibertyFrontend : public Frontend {
 				attributes.push_back(RTLIL::escape_id(args[++argidx]));
 				continue;
 			}
+			if (arg == "-cell" && argidx+1 < args.size()) {
+				cell_patterns.push_back(args[++argidx]);
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
 
-		LibertyParser parser(*f);
+		std::function<bool(const std::string&)> cell_filter;
+		if (!cell_patterns.empty())
+			cell_filter = [&](const std::string &name) {
+				for (auto &pattern : cell_patterns)
+					if (patmatch(pattern.c_str(), name.c_str()))
+						return true;
+				return false;
+			};
+
+		LibertyParser parser(*f, cell_filter);
 		int cell_count = 0;
 
 		std::map<std::string, std::tuple<int, int, bool>> global_type_map;
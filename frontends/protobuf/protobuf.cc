@@ -0,0 +1,330 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/text_format.h>
+
+#include "kernel/yosys.h"
+#include "backends/protobuf/yosys.pb.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+using google::protobuf::internal::WireFormatLite;
+
+struct ProtobufDesignDeserializer
+{
+	Design *design_;
+	Module *module_;
+	dict<int64_t, SigBit> signal_bits_;
+
+	ProtobufDesignDeserializer(Design *design) : design_(design), module_(nullptr) { }
+
+	Const parse_parameter(const yosys::pb::Parameter &param)
+	{
+		Const value;
+
+		if (param.value_case() == yosys::pb::Parameter::kInt) {
+			int width = param.width() ? param.width() : 32;
+			value = Const(State::S0, width);
+			for (int i = 0; i < width && i < 64; i++)
+				if ((uint64_t(param.int_()) >> i) & 1)
+					value.bits[i] = State::S1;
+			if (param.int_() < 0)
+				value.flags |= RTLIL::CONST_FLAG_SIGNED;
+		} else {
+			// Same heuristic as read_json: the writer emits wide constants
+			// as bit strings and everything else flagged as string verbatim.
+			const string &s = param.str();
+			if (!s.empty() && s.find_first_not_of("01xz") == string::npos)
+				value = Const::from_string(s);
+			else
+				value = Const(s);
+		}
+
+		return value;
+	}
+
+	void parse_parameters(dict<IdString, Const> &results, const google::protobuf::Map<std::string, yosys::pb::Parameter> &params)
+	{
+		for (auto &it : params)
+			results[RTLIL::escape_id(it.first)] = parse_parameter(it.second);
+	}
+
+	State parse_constant(const yosys::pb::Signal &signal)
+	{
+		switch (signal.constant()) {
+			case yosys::pb::Signal::CONSTANT_DRIVER_LOW: return State::S0;
+			case yosys::pb::Signal::CONSTANT_DRIVER_HIGH: return State::S1;
+			case yosys::pb::Signal::CONSTANT_DRIVER_Z: return State::Sz;
+			case yosys::pb::Signal::CONSTANT_DRIVER_X: return State::Sx;
+			default:
+				log_error("Protobuf signal in module %s has invalid constant driver %d.\n",
+						log_id(module_), int(signal.constant()));
+		}
+	}
+
+	// Name the bits of a port or netname wire, following the same aliasing
+	// rules as the JSON frontend.
+	void import_wire_bits(Wire *wire, const yosys::pb::BitVector &bits, bool is_port)
+	{
+		for (int i = 0; i < bits.signal_size(); i++)
+		{
+			const yosys::pb::Signal &signal = bits.signal(i);
+			SigBit sigbit(wire, i);
+
+			if (signal.type_case() != yosys::pb::Signal::kId) {
+				module_->connect(sigbit, parse_constant(signal));
+				continue;
+			}
+
+			auto it = signal_bits_.find(signal.id());
+			if (it == signal_bits_.end()) {
+				signal_bits_[signal.id()] = sigbit;
+			} else if (is_port && !wire->port_output) {
+				module_->connect(it->second, sigbit);
+				it->second = sigbit;
+			} else if (sigbit != it->second) {
+				module_->connect(sigbit, it->second);
+			}
+		}
+	}
+
+	SigSpec parse_bits(const yosys::pb::BitVector &bits)
+	{
+		SigSpec sig;
+
+		for (auto &signal : bits.signal()) {
+			if (signal.type_case() != yosys::pb::Signal::kId) {
+				sig.append(parse_constant(signal));
+				continue;
+			}
+			auto it = signal_bits_.find(signal.id());
+			if (it == signal_bits_.end())
+				it = signal_bits_.insert(std::make_pair(signal.id(), SigBit(module_->addWire(NEW_ID)))).first;
+			sig.append(it->second);
+		}
+
+		return sig;
+	}
+
+	void import_module(const string &modname, const yosys::pb::Module &pb_mod)
+	{
+		log("Importing module %s from protobuf stream.\n", RTLIL::unescape_id(modname).c_str());
+
+		IdString name = RTLIL::escape_id(modname);
+		if (design_->module(name))
+			log_error("Re-definition of module %s.\n", log_id(name));
+
+		module_ = design_->addModule(name);
+		signal_bits_.clear();
+
+		parse_parameters(module_->attributes, pb_mod.attribute());
+
+		// Protobuf maps are unordered, so ports are numbered by name.
+		std::vector<string> port_names;
+		for (auto &it : pb_mod.port())
+			port_names.push_back(it.first);
+		std::sort(port_names.begin(), port_names.end());
+
+		int port_id = 1;
+		for (auto &port_name : port_names)
+		{
+			const yosys::pb::Module::Port &pb_port = pb_mod.port().at(port_name);
+			Wire *wire = module_->addWire(RTLIL::escape_id(port_name), pb_port.bits().signal_size());
+
+			switch (pb_port.direction()) {
+				case yosys::pb::DIRECTION_INPUT:
+					wire->port_input = true;
+					break;
+				case yosys::pb::DIRECTION_OUTPUT:
+					wire->port_output = true;
+					break;
+				case yosys::pb::DIRECTION_INOUT:
+					wire->port_input = true;
+					wire->port_output = true;
+					break;
+				default:
+					log_error("Protobuf port %s.%s has invalid direction.\n", log_id(module_), port_name.c_str());
+			}
+
+			wire->port_id = port_id++;
+			import_wire_bits(wire, pb_port.bits(), true);
+		}
+
+		module_->fixup_ports();
+
+		for (auto &pb_net : pb_mod.netname())
+		{
+			IdString net_name = pb_net.name().empty() ? NEW_ID : RTLIL::escape_id(pb_net.name());
+			Wire *wire = module_->wire(net_name);
+
+			if (wire == nullptr)
+				wire = module_->addWire(net_name, pb_net.bits().signal_size());
+			else if (wire->width != pb_net.bits().signal_size())
+				log_error("Protobuf netname %s.%s has a width mismatch with its port.\n", log_id(module_), log_id(net_name));
+
+			import_wire_bits(wire, pb_net.bits(), false);
+			parse_parameters(wire->attributes, pb_net.attributes());
+		}
+
+		for (auto &it : pb_mod.cell())
+		{
+			const yosys::pb::Module::Cell &pb_cell = it.second;
+			Cell *cell = module_->addCell(RTLIL::escape_id(it.first), RTLIL::escape_id(pb_cell.type()));
+
+			for (auto &conn : pb_cell.connection())
+				cell->setPort(RTLIL::escape_id(conn.first), parse_bits(conn.second));
+
+			parse_parameters(cell->parameters, pb_cell.parameter());
+			parse_parameters(cell->attributes, pb_cell.attribute());
+		}
+
+		module_ = nullptr;
+	}
+
+	// Walk the top-level Design fields by hand so that each module is
+	// imported (and freed) as soon as its map entry has been read. Concatenated
+	// per-module messages as written by write_protobuf are handled naturally.
+	//
+	// A CodedInputStream refuses to read more than INT_MAX bytes in total, so a
+	// fresh one is used for every top-level field. Its destructor hands unused
+	// buffered data back to raw_input.
+	void parse_binary(std::istream &f)
+	{
+		google::protobuf::io::IstreamInputStream raw_input(&f);
+
+		while (1)
+		{
+			string modname;
+			yosys::pb::Module pb_mod;
+
+			{
+				google::protobuf::io::CodedInputStream input(&raw_input);
+
+				uint32_t tag = input.ReadTag();
+				if (tag == 0) {
+					if (!input.ConsumedEntireMessage())
+						log_error("Invalid protobuf stream.\n");
+					break;
+				}
+
+				int field = WireFormatLite::GetTagFieldNumber(tag);
+				bool delimited = WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+
+				// The creator string and the AIG models are not needed for import.
+				if (field != yosys::pb::Design::kModulesFieldNumber || !delimited) {
+					if (!WireFormatLite::SkipField(&input, tag))
+						log_error("Invalid protobuf stream.\n");
+					continue;
+				}
+
+				uint32_t length;
+				if (!input.ReadVarint32(&length))
+					log_error("Truncated protobuf stream.\n");
+				auto limit = input.PushLimit(length);
+
+				while (uint32_t entry_tag = input.ReadTag()) {
+					int entry_field = WireFormatLite::GetTagFieldNumber(entry_tag);
+					if (entry_field == 1) {
+						if (!WireFormatLite::ReadString(&input, &modname))
+							log_error("Truncated protobuf stream.\n");
+					} else if (entry_field == 2) {
+						if (!WireFormatLite::ReadMessage(&input, &pb_mod))
+							log_error("Invalid module in protobuf stream.\n");
+					} else if (!WireFormatLite::SkipField(&input, entry_tag)) {
+						log_error("Invalid protobuf stream.\n");
+					}
+				}
+
+				if (!input.ConsumedEntireMessage() || input.BytesUntilLimit() != 0)
+					log_error("Invalid protobuf stream.\n");
+				input.PopLimit(limit);
+			}
+
+			import_module(modname, pb_mod);
+		}
+	}
+
+	void parse_text(std::istream &f)
+	{
+		google::protobuf::io::IstreamInputStream raw_input(&f);
+		yosys::pb::Design pb;
+
+		if (!google::protobuf::TextFormat::Parse(&raw_input, &pb))
+			log_error("Failed to parse protobuf text stream.\n");
+
+		std::vector<string> modnames;
+		for (auto &it : pb.modules())
+			modnames.push_back(it.first);
+		std::sort(modnames.begin(), modnames.end());
+
+		for (auto &modname : modnames)
+			import_module(modname, pb.modules().at(modname));
+	}
+};
+
+struct ProtobufFrontend : public Frontend {
+	ProtobufFrontend() : Frontend("protobuf", "read Protocol Buffer file") { }
+	void help() YS_OVERRIDE
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    read_protobuf [options] [filename]\n");
+		log("\n");
+		log("Load modules from a Protocol Buffer file into the current design. See\n");
+		log("\"help write_protobuf\" for a description of the file format.\n");
+		log("\n");
+		log("    -text\n");
+		log("        read protobuf in Text/ASCII representation\n");
+		log("\n");
+		log("Binary files are imported one module at a time as they are read. Port order,\n");
+		log("wire offsets and the upto flag are not part of the format; ports are numbered\n");
+		log("in alphabetical order.\n");
+		log("\n");
+	}
+	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
+	{
+		bool text_mode = false;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-text") {
+				text_mode = true;
+				continue;
+			}
+			break;
+		}
+		extra_args(f, filename, args, argidx, !text_mode);
+
+		log_header(design, "Executing Protobuf frontend.\n");
+
+		GOOGLE_PROTOBUF_VERIFY_VERSION;
+		ProtobufDesignDeserializer deserializer(design);
+
+		if (text_mode)
+			deserializer.parse_text(*f);
+		else
+			deserializer.parse_binary(*f);
+	}
+} ProtobufFrontend;
+
+PRIVATE_NAMESPACE_END
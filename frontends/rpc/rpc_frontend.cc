@@ -73,6 +73,12 @@ using json11::Json;
 struct RpcServer {
 	std::string name;
 
+	// whether the frontend accepts several derive requests in one message
+	bool derive_batch = false;
+
+	// responses to derive requests, keyed by the serialized module name and parameters
+	dict<std::string, std::pair<std::string, std::string>> derive_cache;
+
 	RpcServer(const std::string &name) : name(name) { }
 	virtual ~RpcServer() { }
 
@@ -112,10 +118,11 @@ struct RpcServer {
 		} else is_valid = false;
 		if (!is_valid)
 			log_cmd_error("RPC frontend returned malformed response: %s\n", response.dump().c_str());
+		derive_batch = response["derive_batch"].bool_value();
 		return modules;
 	}
 
-	std::pair<std::string, std::string> derive_module(const std::string &module, const dict<RTLIL::IdString, RTLIL::Const> &parameters) {
+	static Json::object derive_request(const std::string &module, const dict<RTLIL::IdString, RTLIL::Const> &parameters) {
 		Json::object json_parameters;
 		for (auto &param : parameters) {
 			std::string type, value;
@@ -135,22 +142,65 @@ struct RpcServer {
 				{ "value", value },
 			};
 		}
-		Json response = call(Json::object {
-			{ "method", "derive" },
+		return Json::object {
 			{ "module", module },
 			{ "parameters", json_parameters },
+		};
+	}
+
+	static bool parse_derive_response(const Json &response, std::pair<std::string, std::string> &result) {
+		if (!response["frontend"].is_string() || !response["source"].is_string())
+			return false;
+		result = std::make_pair(response["frontend"].string_value(), response["source"].string_value());
+		return true;
+	}
+
+	std::pair<std::string, std::string> derive_module(const std::string &module, const dict<RTLIL::IdString, RTLIL::Const> &parameters) {
+		Json::object json_request = derive_request(module, parameters);
+		std::string cache_key = Json(json_request).dump();
+		if (derive_cache.count(cache_key)) {
+			log("Using cached RPC frontend response for module `%s'.\n", module.c_str());
+			return derive_cache.at(cache_key);
+		}
+		json_request["method"] = "derive";
+		Json response = call(json_request);
+		std::pair<std::string, std::string> result;
+		if (!parse_derive_response(response, result))
+			log_cmd_error("RPC frontend returned malformed response: %s\n", response.dump().c_str());
+		derive_cache[cache_key] = result;
+		return result;
+	}
+
+	// Fetch the responses to several derive requests in a single round trip. Requests that
+	// are already cached are skipped; requests the frontend answers with an error are not
+	// cached, so that the error is reported when the module is actually derived.
+	void derive_modules(const std::vector<Json::object> &requests) {
+		Json::array batch;
+		std::vector<std::string> cache_keys;
+		for (auto &request : requests) {
+			std::string cache_key = Json(request).dump();
+			if (derive_cache.count(cache_key) || std::find(cache_keys.begin(), cache_keys.end(), cache_key) != cache_keys.end())
+				continue;
+			batch.push_back(request);
+			cache_keys.push_back(cache_key);
+		}
+		if (batch.size() < 2)
+			return;
+
+		log("Requesting %d derived modules from RPC frontend in one batch.\n", GetSize(batch));
+		Json response = call(Json::object {
+			{ "method", "derive" },
+			{ "batch", batch },
 		});
-		bool is_valid = true;
-		std::string frontend, source;
-		if (response["frontend"].is_string())
-			frontend = response["frontend"].string_value();
-		else is_valid = false;
-		if (response["source"].is_string())
-			source = response["source"].string_value();
-		else is_valid = false;
-		if (!is_valid)
+		if (!response["batch"].is_array() || response["batch"].array_items().size() != batch.size())
 			log_cmd_error("RPC frontend returned malformed response: %s\n", response.dump().c_str());
-		return std::make_pair(frontend, source);
+		for (size_t i = 0; i < batch.size(); i++) {
+			std::pair<std::string, std::string> result;
+			if (parse_derive_response(response["batch"][i], result))
+				derive_cache[cache_keys[i]] = result;
+			else if (!response["batch"][i]["error"].is_string())
+				log_cmd_error("RPC frontend returned malformed response: %s\n", response.dump().c_str());
+		}
 	}
 };
 
@@ -182,6 +232,20 @@ struct RpcModule : RTLIL::Module {
 		if (design->has(derived_name)) {
 			log("Found cached RTLIL representation for module `%s'.\n", derived_name.c_str());
 		} else {
+			if (server->derive_batch) {
+				// Other instances of modules from the same frontend are usually derived right
+				// after this one, so ask for all of them at once.
+				std::vector<Json::object> requests;
+				requests.push_back(RpcServer::derive_request(stripped_name.substr(1), parameters));
+				for (auto module : design->modules())
+				for (auto cell : module->cells()) {
+					RpcModule *rpc_module = dynamic_cast<RpcModule*>(design->module("$abstract" + cell->type.str()));
+					if (rpc_module != nullptr && rpc_module->server == server)
+						requests.push_back(RpcServer::derive_request(cell->type.str().substr(1), cell->parameters));
+				}
+				server->derive_modules(requests);
+			}
+
 			std::string command, input;
 			std::tie(command, input) = server->derive_module(stripped_name.substr(1), parameters);
 
@@ -367,11 +431,13 @@ struct RpcFrontend : public Pass {
 		log("1 line of JSON as well.\n");
 		log("\n");
 		log("    -> {\"method\": \"modules\"}\n");
-		log("    <- {\"modules\": [\"<module-name>\", ...]}\n");
+		log("    <- {\"modules\": [\"<module-name>\", ...], \"derive_batch\": [true|false]}\n");
 		log("    <- {\"error\": \"<error-message>\"}\n");
 		log("        request for the list of modules that can be derived by this frontend.\n");
 		log("        the 'hierarchy' command will call back into this frontend if a cell\n");
-		log("        with type <module-name> is instantiated in the design.\n");
+		log("        with type <module-name> is instantiated in the design. the optional\n");
+		log("        \"derive_batch\" field indicates that the frontend accepts the batched\n");
+		log("        form of the derive request described below.\n");
 		log("\n");
 		log("    -> {\"method\": \"derive\", \"module\": \"<module-name\">, \"parameters\": {\n");
 		log("        \"<param-name>\": {\"type\": \"[unsigned|signed|string|real]\",\n");
@@ -386,7 +452,19 @@ struct RpcFrontend : public Pass {
 		log("        by a built-in Yosys <frontend>, allowing the RPC frontend to return any\n");
 		log("        convenient representation of the module. the derived module is cached,\n");
 		log("        so the response should be the same whenever the same set of parameters\n");
-		log("        is provided.\n");
+		log("        is provided. the response is also kept for the lifetime of the\n");
+		log("        connection, so that deriving the module again in a different design\n");
+		log("        (e.g. after 'design -load') does not need another round trip.\n");
+		log("\n");
+		log("    -> {\"method\": \"derive\", \"batch\": [\n");
+		log("        {\"module\": \"<module-name>\", \"parameters\": {...}}, ...]}\n");
+		log("    <- {\"batch\": [{\"frontend\": ..., \"source\": ...}|{\"error\": ...}, ...]}\n");
+		log("    <- {\"error\": \"<error-message>\"}\n");
+		log("        request for several modules to be derived in one round trip, with one\n");
+		log("        response per request, in the same order. only sent to frontends that\n");
+		log("        set \"derive_batch\". when the first module is derived, all other\n");
+		log("        instances of modules from the same frontend that are already present\n");
+		log("        in the design are requested along with it.\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
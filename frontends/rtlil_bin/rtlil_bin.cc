@@ -0,0 +1,444 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/register.h"
+#include "kernel/log.h"
+#include "backends/rtlil_bin/rtlil_bin.h"
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct RtlilBinReader
+{
+	std::string filename;
+	const unsigned char *ptr, *end;
+	std::vector<RTLIL::IdString> strings;
+	std::vector<RTLIL::Wire*> wires;
+
+	RtlilBinReader(const std::string &filename, const unsigned char *data, size_t size) :
+			filename(filename), ptr(data), end(data + size) { }
+
+	void error()
+	{
+		log_error("File `%s' is not a binary checkpoint of this Yosys version, or it is truncated or corrupted.\n", filename.c_str());
+	}
+
+	uint64_t get_uint()
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (ptr == end)
+				error();
+			unsigned char byte = *ptr++;
+			value |= uint64_t(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		error();
+		return 0;
+	}
+
+	int get_int()
+	{
+		uint64_t value = get_uint();
+		int64_t result = int64_t(value >> 1) ^ -int64_t(value & 1);
+		if (result < INT_MIN || result > INT_MAX)
+			error();
+		return result;
+	}
+
+	int get_uint_int()
+	{
+		uint64_t value = get_uint();
+		if (value > uint64_t(INT_MAX))
+			error();
+		return value;
+	}
+
+	// a number of elements that follow, each element takes at least one byte
+	int get_count()
+	{
+		int count = get_uint_int();
+		if (count > end - ptr)
+			error();
+		return count;
+	}
+
+	RTLIL::IdString get_id()
+	{
+		uint64_t index = get_uint();
+		if (index >= strings.size())
+			error();
+		return strings[index];
+	}
+
+	void get_bits(std::vector<RTLIL::State> &bits)
+	{
+		int width = get_uint_int();
+		if (ptr == end)
+			error();
+		int packing = *ptr++;
+		if (packing != RTLIL_BIN::PACK_BITS && packing != RTLIL_BIN::PACK_NIBBLES)
+			error();
+
+		int per_byte = packing == RTLIL_BIN::PACK_BITS ? 8 : 2;
+		if ((width + per_byte - 1) / per_byte > end - ptr)
+			error();
+
+		bits.resize(width);
+		for (int i = 0; i < width; i++) {
+			int value = (ptr[i / per_byte] >> ((i % per_byte) * (8 / per_byte))) & (per_byte == 8 ? 1 : 15);
+			if (value > RTLIL::Sm)
+				error();
+			bits[i] = RTLIL::State(value);
+		}
+		ptr += (width + per_byte - 1) / per_byte;
+	}
+
+	RTLIL::Const get_const()
+	{
+		RTLIL::Const value;
+		value.flags = get_uint_int();
+		get_bits(value.bits);
+		return value;
+	}
+
+	RTLIL::SigSpec get_sigspec()
+	{
+		RTLIL::SigSpec sig;
+		for (int count = get_count(); count > 0; count--) {
+			uint64_t index = get_uint();
+			if (index == 0) {
+				RTLIL::Const value;
+				get_bits(value.bits);
+				sig.append(value);
+			} else {
+				if (index > wires.size())
+					error();
+				RTLIL::Wire *wire = wires[index-1];
+				int offset = get_uint_int();
+				int width = get_uint_int();
+				if (offset > wire->width || width > wire->width - offset)
+					error();
+				sig.append(RTLIL::SigSpec(wire, offset, width));
+			}
+		}
+		return sig;
+	}
+
+	void get_sigsigs(std::vector<RTLIL::SigSig> &sigsigs)
+	{
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::SigSpec lhs = get_sigspec();
+			RTLIL::SigSpec rhs = get_sigspec();
+			if (GetSize(lhs) != GetSize(rhs))
+				error();
+			sigsigs.push_back(RTLIL::SigSig(lhs, rhs));
+		}
+	}
+
+	void get_consts(dict<RTLIL::IdString, RTLIL::Const> &consts)
+	{
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::IdString name = get_id();
+			consts[name] = get_const();
+		}
+	}
+
+	void get_case(RTLIL::CaseRule *cs)
+	{
+		get_consts(cs->attributes);
+		for (int count = get_count(); count > 0; count--)
+			cs->compare.push_back(get_sigspec());
+		get_sigsigs(cs->actions);
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::SwitchRule *sw = new RTLIL::SwitchRule;
+			cs->switches.push_back(sw);
+			get_switch(sw);
+		}
+	}
+
+	void get_switch(RTLIL::SwitchRule *sw)
+	{
+		get_consts(sw->attributes);
+		sw->signal = get_sigspec();
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::CaseRule *cs = new RTLIL::CaseRule;
+			sw->cases.push_back(cs);
+			get_case(cs);
+		}
+	}
+
+	void get_module(RTLIL::Module *module)
+	{
+		get_consts(module->attributes);
+
+		for (int count = get_count(); count > 0; count--)
+			module->avail_parameters.insert(get_id());
+
+		wires.clear();
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::IdString name = get_id();
+			if (module->wire(name) != nullptr)
+				error();
+			RTLIL::Wire *wire = module->addWire(name, get_uint_int());
+			wire->start_offset = get_int();
+			wire->port_id = get_uint_int();
+			int flags = get_uint_int();
+			wire->port_input = (flags & RTLIL_BIN::WIRE_INPUT) != 0;
+			wire->port_output = (flags & RTLIL_BIN::WIRE_OUTPUT) != 0;
+			wire->upto = (flags & RTLIL_BIN::WIRE_UPTO) != 0;
+			get_consts(wire->attributes);
+			wires.push_back(wire);
+		}
+
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::IdString name = get_id();
+			if (module->memories.count(name))
+				error();
+			RTLIL::Memory *memory = new RTLIL::Memory;
+			memory->name = name;
+			module->memories[name] = memory;
+			memory->width = get_uint_int();
+			memory->start_offset = get_int();
+			memory->size = get_uint_int();
+			get_consts(memory->attributes);
+		}
+
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::IdString name = get_id();
+			if (module->cell(name) != nullptr)
+				error();
+			RTLIL::Cell *cell = module->addCell(name, get_id());
+			get_consts(cell->parameters);
+			get_consts(cell->attributes);
+			for (int port_count = get_count(); port_count > 0; port_count--) {
+				RTLIL::IdString port = get_id();
+				cell->setPort(port, get_sigspec());
+			}
+		}
+
+		for (int count = get_count(); count > 0; count--) {
+			RTLIL::IdString name = get_id();
+			if (module->processes.count(name))
+				error();
+			RTLIL::Process *proc = new RTLIL::Process;
+			proc->name = name;
+			module->processes[name] = proc;
+			get_consts(proc->attributes);
+			get_case(&proc->root_case);
+			for (int sync_count = get_count(); sync_count > 0; sync_count--) {
+				RTLIL::SyncRule *sync = new RTLIL::SyncRule;
+				proc->syncs.push_back(sync);
+				uint64_t type = get_uint();
+				if (type > RTLIL::STi)
+					error();
+				sync->type = RTLIL::SyncType(type);
+				sync->signal = get_sigspec();
+				get_sigsigs(sync->actions);
+			}
+		}
+
+		std::vector<RTLIL::SigSig> connections;
+		get_sigsigs(connections);
+		for (auto &conn : connections)
+			module->connect(conn);
+
+		module->fixup_ports();
+	}
+
+	void read(RTLIL::Design *design, const pool<RTLIL::IdString> &only_modules, bool flag_nooverwrite, bool flag_overwrite, bool flag_lib)
+	{
+		if (end - ptr < RTLIL_BIN::magic_len || memcmp(ptr, RTLIL_BIN::magic, RTLIL_BIN::magic_len) != 0)
+			error();
+		ptr += RTLIL_BIN::magic_len;
+		if (get_uint() != RTLIL_BIN::version)
+			error();
+
+		autoidx = max(autoidx, get_uint_int());
+
+		for (int count = get_count(); count > 0; count--) {
+			int len = get_count();
+			std::string str((const char*)ptr, len);
+			ptr += len;
+			if (GetSize(str) < 2 || (str[0] != '\\' && str[0] != '$'))
+				error();
+			strings.push_back(str);
+		}
+
+		for (int count = get_count(); count > 0; count--)
+		{
+			RTLIL::IdString name = get_id();
+			uint64_t size = get_uint();
+			if (size > uint64_t(end - ptr))
+				error();
+			const unsigned char *module_end = ptr + size;
+
+			if (!only_modules.empty() && !only_modules.count(name)) {
+				ptr = module_end;
+				continue;
+			}
+
+			RTLIL::Module *module = new RTLIL::Module;
+			module->name = name;
+
+			const unsigned char *file_end = end;
+			end = module_end;
+			get_module(module);
+			if (ptr != module_end)
+				error();
+			end = file_end;
+
+			// same handling of existing modules as in the ilang frontend
+			if (design->has(name)) {
+				RTLIL::Module *existing_mod = design->module(name);
+				if (!flag_overwrite && (flag_lib || module->get_bool_attribute(ID(blackbox)))) {
+					log("Ignoring blackbox re-definition of module %s.\n", log_id(name));
+					delete module;
+					continue;
+				} else if (!flag_nooverwrite && !flag_overwrite && !existing_mod->get_bool_attribute(ID(blackbox))) {
+					log_error("Re-definition of module %s.\n", log_id(name));
+				} else if (flag_nooverwrite) {
+					log("Ignoring re-definition of module %s.\n", log_id(name));
+					delete module;
+					continue;
+				} else {
+					log("Replacing existing%s module %s.\n", existing_mod->get_bool_attribute(ID(blackbox)) ? " blackbox" : "", log_id(name));
+					design->remove(existing_mod);
+				}
+			}
+
+			design->add(module);
+			if (flag_lib)
+				module->makeblackbox();
+		}
+	}
+};
+
+struct RtlilBinFrontend : public Frontend {
+	RtlilBinFrontend() : Frontend("rtlil_bin", "read design from a binary checkpoint file") { }
+	void help() YS_OVERRIDE
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    read_rtlil_bin [options] [filename]\n");
+		log("\n");
+		log("Load modules from a binary checkpoint file written by 'write_rtlil_bin'. The\n");
+		log("file is mapped into memory when possible. Modules that are not loaded (see\n");
+		log("-module) are skipped without being decoded.\n");
+		log("\n");
+		log("    -module <name>\n");
+		log("        only load the given module. can be specified multiple times.\n");
+		log("\n");
+		log("    -nooverwrite\n");
+		log("        ignore re-definitions of modules. (the default behavior is to\n");
+		log("        create an error message if the existing module is not a blackbox\n");
+		log("        module, and overwrite the existing module if it is a blackbox module.)\n");
+		log("\n");
+		log("    -overwrite\n");
+		log("        overwrite existing modules with the same name\n");
+		log("\n");
+		log("    -lib\n");
+		log("        only create empty blackbox modules\n");
+		log("\n");
+	}
+	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
+	{
+		bool flag_nooverwrite = false;
+		bool flag_overwrite = false;
+		bool flag_lib = false;
+		pool<RTLIL::IdString> only_modules;
+
+		log_header(design, "Executing RTLIL_BIN frontend.\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			std::string arg = args[argidx];
+			if (arg == "-module" && argidx+1 < args.size()) {
+				only_modules.insert(RTLIL::escape_id(args[++argidx]));
+				continue;
+			}
+			if (arg == "-nooverwrite") {
+				flag_nooverwrite = true;
+				flag_overwrite = false;
+				continue;
+			}
+			if (arg == "-overwrite") {
+				flag_nooverwrite = false;
+				flag_overwrite = true;
+				continue;
+			}
+			if (arg == "-lib") {
+				flag_lib = true;
+				continue;
+			}
+			break;
+		}
+		extra_args(f, filename, args, argidx, true);
+
+		log("Input filename: %s\n", filename.c_str());
+
+		const unsigned char *data = nullptr;
+		size_t size = 0;
+		std::string buffer;
+
+#ifndef _WIN32
+		// plain files are mapped into memory, compressed files and stdin are read into a buffer
+		void *mapping = MAP_FAILED;
+		if (dynamic_cast<std::ifstream*>(f) != nullptr) {
+			int fd = open(filename.c_str(), O_RDONLY);
+			struct stat st;
+			if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+				mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapping != MAP_FAILED) {
+					data = (const unsigned char*)mapping;
+					size = st.st_size;
+				}
+			}
+			if (fd >= 0)
+				close(fd);
+		}
+#endif
+
+		if (data == nullptr) {
+			std::stringstream ss;
+			ss << f->rdbuf();
+			buffer = ss.str();
+			data = (const unsigned char*)buffer.data();
+			size = buffer.size();
+		}
+
+		RtlilBinReader reader(filename, data, size);
+		reader.read(design, only_modules, flag_nooverwrite, flag_overwrite, flag_lib);
+
+#ifndef _WIN32
+		if (mapping != MAP_FAILED)
+			munmap(mapping, size);
+#endif
+	}
+} RtlilBinFrontend;
+
+PRIVATE_NAMESPACE_END
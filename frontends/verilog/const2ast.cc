@@ -96,10 +96,26 @@ static void my_strtobin(std::vector<RTLIL::State> &data, const char *str, int le
 	data.clear();
 
 	if (base == 10) {
-		while (!digits.empty())
-			data.push_back(my_decimal_div_by_two(digits) ? State::S1 : State::S0);
+		bool fits_uint64 = GetSize(digits) <= 19;
+		for (auto d : digits)
+			if (d >= 10)
+				fits_uint64 = false;
+		if (fits_uint64 && !digits.empty()) {
+			// fast path for the common case of small decimal numbers
+			uint64_t value = 0;
+			for (auto d : digits)
+				value = value * 10 + d;
+			do {
+				data.push_back((value & 1) ? State::S1 : State::S0);
+				value = value >> 1;
+			} while (value != 0);
+		} else {
+			while (!digits.empty())
+				data.push_back(my_decimal_div_by_two(digits) ? State::S1 : State::S0);
+		}
 	} else {
 		int bits_per_digit = my_ilog2(base-1);
+		data.reserve(GetSize(digits) * bits_per_digit);
 		for (auto it = digits.rbegin(), e = digits.rend(); it != e; it++) {
 			if (*it > (base-1) && *it < 0xf0)
 				log_file_error(current_filename, get_line_num(), "Digit larger than %d used in in base-%d constant.\n",
@@ -174,9 +190,9 @@ AstNode *VERILOG_FRONTEND::const2ast(std::string code, char case_type, bool warn
 		return ast;
 	}
 
-	for (size_t i = 0; i < code.size(); i++)
-		if (code[i] == '_' || code[i] == ' ' || code[i] == '\t' || code[i] == '\r' || code[i] == '\n')
-			code.erase(code.begin()+(i--));
+	code.erase(std::remove_if(code.begin(), code.end(), [](char ch) {
+		return ch == '_' || ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+	}), code.end());
 	str = code.c_str();
 
 	char *endptr;
@@ -41,7 +41,7 @@
 YOSYS_NAMESPACE_BEGIN
 using namespace VERILOG_FRONTEND;
 
-static std::list<std::string> output_code;
+static std::string output_code;
 static std::list<std::string> input_buffer;
 static size_t input_buffer_charp;
 
@@ -105,7 +105,7 @@ static std::string next_token(bool pass_newline = false)
 	token += ch;
 	if (ch == '\n') {
 		if (pass_newline) {
-			output_code.push_back(token);
+			output_code += token;
 			return "";
 		}
 		return token;
@@ -304,6 +304,13 @@ std::string frontend_verilog_preproc(std::istream &f, std::string filename, cons
 		std::string tok = next_token();
 		// printf("token: >>%s<<\n", tok != "\n" ? tok.c_str() : "NEWLINE");
 
+		// only tokens starting with a backtick can be directives or macros
+		if (tok.empty() || tok[0] != '`') {
+			if (ifdef_fail_level == 0 || tok == "\n")
+				output_code += tok;
+			continue;
+		}
+
 		if (tok == "`endif") {
 			if (ifdef_fail_level > 0)
 				ifdef_fail_level--;
@@ -348,7 +355,7 @@ std::string frontend_verilog_preproc(std::istream &f, std::string filename, cons
 
 		if (ifdef_fail_level > 0) {
 			if (tok == "\n")
-				output_code.push_back(tok);
+				output_code += tok;
 			continue;
 		}
 
@@ -431,7 +438,7 @@ std::string frontend_verilog_preproc(std::istream &f, std::string filename, cons
 			if (ff.fail()) {
 				std::cerr << "\tResult: Not found." << std::endl;
 
-				output_code.push_back("`file_notfound " + fn);
+				output_code += "`file_notfound " + fn;
 			} else {
 				std::cerr << "\tResult: Found." << std::endl;
 
@@ -446,14 +453,14 @@ std::string frontend_verilog_preproc(std::istream &f, std::string filename, cons
 			std::string fn = next_token(true);
 			if (!fn.empty() && fn.front() == '"' && fn.back() == '"')
 				fn = fn.substr(1, fn.size()-2);
-			output_code.push_back(tok + " \"" + fn + "\"");
+			output_code += tok + " \"" + fn + "\"";
 			filename_stack.push_back(filename);
 			filename = fn;
 			continue;
 		}
 
 		if (tok == "`file_pop") {
-			output_code.push_back(tok);
+			output_code += tok;
 			filename = filename_stack.back();
 			filename_stack.pop_back();
 			continue;
@@ -561,14 +568,12 @@ std::string frontend_verilog_preproc(std::istream &f, std::string filename, cons
 		if (try_expand_macro(defines_with_args, defines_map, tok))
 			continue;
 
-		output_code.push_back(tok);
+		output_code += tok;
 	}
 
 	std::string output;
-	for (auto &str : output_code)
-		output += str;
+	output.swap(output_code);
 
-	output_code.clear();
 	input_buffer.clear();
 	input_buffer_charp = 0;
 
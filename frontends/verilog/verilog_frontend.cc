@@ -29,7 +29,9 @@
 #include "verilog_frontend.h"
 #include "kernel/yosys.h"
 #include "libs/sha1/sha1.h"
+#include "backends/rtlil_bin/rtlil_bin.h"
 #include <stdarg.h>
+#include <sys/stat.h>
 
 YOSYS_NAMESPACE_BEGIN
 using namespace VERILOG_FRONTEND;
@@ -39,6 +41,33 @@ using namespace VERILOG_FRONTEND;
 static std::vector<std::string> verilog_defaults;
 static std::list<std::vector<std::string>> verilog_defaults_stack;
 
+// Cell libraries in the share directory (e.g. the cells_sim.v files read by the synth_*
+// scripts) can have a snapshot of 'read_verilog -lib' next to them, written by
+// 'write_rtlil_bin' at build time. Returns the snapshot file name, or an empty string if
+// there is no snapshot, it is older than the source or it was written in another format.
+static std::string lib_snapshot_filename(const std::string &filename)
+{
+	std::string share_dirname = proc_share_dirname();
+	if (filename.compare(0, share_dirname.size(), share_dirname) != 0)
+		return std::string();
+	if (filename.size() < 2 || filename.compare(filename.size()-2, 2, ".v") != 0)
+		return std::string();
+
+	std::string snapshot = filename.substr(0, filename.size()-2) + ".lib.rtlil_bin";
+	struct stat source_st, snapshot_st;
+	if (stat(filename.c_str(), &source_st) != 0 || stat(snapshot.c_str(), &snapshot_st) != 0)
+		return std::string();
+	if (snapshot_st.st_mtime < source_st.st_mtime)
+		return std::string();
+
+	std::ifstream f(snapshot.c_str(), std::ios::binary);
+	char header[RTLIL_BIN::magic_len + 1];
+	if (!f.read(header, sizeof(header)) || memcmp(header, RTLIL_BIN::magic, RTLIL_BIN::magic_len) != 0 ||
+			header[RTLIL_BIN::magic_len] != RTLIL_BIN::version)
+		return std::string();
+	return snapshot;
+}
+
 static void error_on_dpi_function(AST::AstNode *node)
 {
 	if (node->type == AST::AST_DPI_FUNCTION)
@@ -153,6 +182,11 @@ struct VerilogFrontend : public Frontend {
 		log("        only create empty blackbox modules. This implies -DBLACKBOX.\n");
 		log("        modules with the (* whitebox *) attribute will be preserved.\n");
 		log("        (* lib_whitebox *) will be treated like (* whitebox *).\n");
+		log("        for files in the Yosys share directory (e.g. '+/ecp5/cells_sim.v')\n");
+		log("        that are read with no other options, a snapshot written by\n");
+		log("        'write_rtlil_bin' at build time (e.g. '+/ecp5/cells_sim.lib.rtlil_bin')\n");
+		log("        is loaded instead, unless it is older than the Verilog file or\n");
+		log("        defines have been set with 'verilog_defines'.\n");
 		log("\n");
 		log("    -nowb\n");
 		log("        delete (* whitebox *) and (* lib_whitebox *) attributes from\n");
@@ -184,6 +218,20 @@ struct VerilogFrontend : public Frontend {
 		log("        to a later 'hierarchy' command. Useful in cases where the default\n");
 		log("        parameters of modules yield invalid or not synthesizable code.\n");
 		log("\n");
+		log("    -incremental\n");
+		log("        for re-reading source files into a design that already contains\n");
+		log("        them. the modules read from each file are tagged with a hash of\n");
+		log("        the file contents and the read_verilog options (attribute\n");
+		log("        'src_sha1', also set on modules derived from them by 'hierarchy').\n");
+		log("        if all modules in the design that were read from a\n");
+		log("        file carry the matching hash, the file is skipped. otherwise all\n");
+		log("        modules from that file, including parametric variants derived\n");
+		log("        from them, are removed and the file is read again. this implies\n");
+		log("        -overwrite. note that changes in included files are not detected,\n");
+		log("        and that cells in other modules that already refer to a removed\n");
+		log("        parametric variant are not updated, so this is best combined with\n");
+		log("        -defer on a design that has not been elaborated yet.\n");
+		log("\n");
 		log("    -noautowire\n");
 		log("        make the default of `default_nettype be \"none\" instead of \"wire\".\n");
 		log("\n");
@@ -235,6 +283,7 @@ struct VerilogFrontend : public Frontend {
 		bool flag_nooverwrite = false;
 		bool flag_overwrite = false;
 		bool flag_defer = false;
+		bool flag_incremental = false;
 		bool flag_noblackbox = false;
 		bool flag_nowb = false;
 		std::map<std::string, std::string> defines_map;
@@ -390,6 +439,10 @@ struct VerilogFrontend : public Frontend {
 				flag_defer = true;
 				continue;
 			}
+			if (arg == "-incremental") {
+				flag_incremental = true;
+				continue;
+			}
 			if (arg == "-noautowire") {
 				default_nettype_wire = false;
 				continue;
@@ -429,8 +482,70 @@ struct VerilogFrontend : public Frontend {
 		}
 		extra_args(f, filename, args, argidx);
 
+		if (argidx == 2 && args[1] == "-lib" && design->verilog_defines.empty()) {
+			std::string snapshot = lib_snapshot_filename(filename);
+			if (!snapshot.empty()) {
+				log_header(design, "Executing Verilog-2005 frontend: %s\n", filename.c_str());
+				log("Loading snapshot `%s' instead of parsing the Verilog source.\n", snapshot.c_str());
+				// next_args is shared by all frontends, keep the remaining files of this call
+				std::vector<std::string> saved_next_args;
+				std::swap(saved_next_args, next_args);
+				Frontend::frontend_call(design, nullptr, snapshot, "rtlil_bin");
+				std::swap(saved_next_args, next_args);
+				return;
+			}
+		}
+
 		log_header(design, "Executing Verilog-2005 frontend: %s\n", filename.c_str());
 
+		std::istream *in = f;
+		std::istringstream incremental_stream;
+		std::string incremental_hash;
+
+		if (flag_incremental)
+		{
+			std::stringstream buffer;
+			buffer << f->rdbuf();
+
+			std::string hash_data;
+			for (size_t i = 1; i < argidx; i++)
+				hash_data += args[i] + " ";
+			hash_data += "\n" + buffer.str();
+			incremental_hash = sha1(hash_data);
+
+			std::vector<RTLIL::Module*> file_modules;
+			bool unchanged = true;
+			for (auto mod : design->modules()) {
+				std::string src = mod->get_src_attribute();
+				if (src.compare(0, filename.size()+1, filename + ":") != 0)
+					continue;
+				if (!mod->attributes.count(ID(src_sha1)) || mod->attributes.at(ID(src_sha1)).decode_string() != incremental_hash)
+					unchanged = false;
+				file_modules.push_back(mod);
+			}
+
+			if (unchanged && !file_modules.empty()) {
+				log("Skipping unchanged file `%s'.\n", filename.c_str());
+				return;
+			}
+
+			for (auto mod : file_modules) {
+				log("Removing module `%s' read from an earlier version of `%s'.\n", log_id(mod), filename.c_str());
+				design->remove(mod);
+			}
+
+			if (!flag_nooverwrite)
+				flag_overwrite = true;
+
+			incremental_stream.str(buffer.str());
+			in = &incremental_stream;
+		}
+
+		pool<RTLIL::IdString> old_modules;
+		if (flag_incremental)
+			for (auto &it : design->modules_)
+				old_modules.insert(it.first);
+
 		log("Parsing %s%s input from `%s' to AST representation.\n",
 				formal_mode ? "formal " : "", sv_mode ? "SystemVerilog" : "Verilog", filename.c_str());
 
@@ -440,11 +555,11 @@ struct VerilogFrontend : public Frontend {
 
 		current_ast = new AST::AstNode(AST::AST_DESIGN);
 
-		lexin = f;
+		lexin = in;
 		std::string code_after_preproc;
 
 		if (!flag_nopp) {
-			code_after_preproc = frontend_verilog_preproc(*f, filename, defines_map, design->verilog_defines, include_dirs);
+			code_after_preproc = frontend_verilog_preproc(*in, filename, defines_map, design->verilog_defines, include_dirs);
 			if (flag_ppdump)
 				log("-- Verilog code after preprocessor --\n%s-- END OF DUMP --\n", code_after_preproc.c_str());
 			lexin = new std::istringstream(code_after_preproc);
@@ -468,6 +583,11 @@ struct VerilogFrontend : public Frontend {
 		AST::process(design, current_ast, flag_dump_ast1, flag_dump_ast2, flag_no_dump_ptr, flag_dump_vlog1, flag_dump_vlog2, flag_dump_rtlil, flag_nolatches,
 				flag_nomeminit, flag_nomem2reg, flag_mem2reg, flag_noblackbox, lib_mode, flag_nowb, flag_noopt, flag_icells, flag_pwires, flag_nooverwrite, flag_overwrite, flag_defer, default_nettype_wire);
 
+		if (flag_incremental)
+			for (auto mod : design->modules())
+				if (!old_modules.count(mod->name))
+					mod->attributes[ID(src_sha1)] = RTLIL::Const(incremental_hash);
+
 		if (!flag_nopp)
 			delete lexin;
 
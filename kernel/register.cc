@@ -407,7 +407,15 @@ void ScriptPass::run_script(RTLIL::Design *design, std::string run_from, std::st
 	block_active = run_from.empty();
 	active_run_from = run_from;
 	active_run_to = run_to;
+
+	// Scripts call techmap many times with the same map files. Keep the parsed map files
+	// for the duration of the script, unless the user has set techmap.cache explicitly.
+	bool enable_techmap_cache = design->scratchpad.count("techmap.cache") == 0;
+	if (enable_techmap_cache)
+		design->scratchpad_set_bool("techmap.cache", true);
 	script();
+	if (enable_techmap_cache)
+		design->scratchpad_unset("techmap.cache");
 }
 
 void ScriptPass::help_script()
@@ -1058,6 +1058,11 @@ public:
 	int refcount_wires_;
 	int refcount_cells_;
 
+	// incremented on every change made through the module and cell API (adding,
+	// removing or renaming wires and cells, connections and cell parameters)
+	unsigned int changes_;
+	unsigned int changes() const { return changes_; }
+
 	dict<RTLIL::IdString, RTLIL::Wire*> wires_;
 	dict<RTLIL::IdString, RTLIL::Cell*> cells_;
 	std::vector<RTLIL::SigSig> connections_;
@@ -265,17 +265,12 @@ statdata_t hierarchy_worker(std::map<RTLIL::IdString, statdata_t> &mod_stat, RTL
 	return mod_data;
 }
 
-void read_liberty_cellarea(dict<IdString, double> &cell_area, string liberty_file)
+void read_liberty_cellarea(dict<IdString, double> &cell_area, string liberty_file, bool use_cache)
 {
-	std::ifstream f;
-	f.open(liberty_file.c_str());
 	yosys_input_files.insert(liberty_file);
-	if (f.fail())
-		log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-	LibertyParser libparser(f);
-	f.close();
+	std::shared_ptr<LibertyAst> libast = LibertyAstCache::instance.parse(liberty_file, use_cache);
 
-	for (auto cell : libparser.ast->children)
+	for (auto cell : libast->children)
 	{
 		if (cell->id != "cell" || cell->args.size() != 1)
 			continue;
@@ -303,7 +298,9 @@ struct StatPass : public Pass {
 		log("        default value for this option.\n");
 		log("\n");
 		log("    -liberty <liberty_file>\n");
-		log("        use cell area information from the provided liberty file\n");
+		log("        use cell area information from the provided liberty file. the parsed\n");
+		log("        file is cached when the scratchpad variable 'libparse.cache' is set\n");
+		log("        (see 'help dfflibmap').\n");
 		log("\n");
 		log("    -tech <technology>\n");
 		log("        print area estemate for the specified technology. Currently supported\n");
@@ -334,7 +331,7 @@ struct StatPass : public Pass {
 			if (args[argidx] == "-liberty" && argidx+1 < args.size()) {
 				string liberty_file = args[++argidx];
 				rewrite_filename(liberty_file);
-				read_liberty_cellarea(cell_area, liberty_file);
+				read_liberty_cellarea(cell_area, liberty_file, design->scratchpad_get_bool("libparse.cache"));
 				continue;
 			}
 			if (args[argidx] == "-tech" && argidx+1 < args.size()) {
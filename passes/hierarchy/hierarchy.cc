@@ -627,6 +627,13 @@ struct HierarchyPass : public Pass {
 		log("       This option can be specified multiple times to override multiple\n");
 		log("       parameters. String values must be passed in double quotes (\").\n");
 		log("\n");
+		log("When the scratchpad variable 'ast.derive_cache' is set to the name of an\n");
+		log("existing directory (e.g. 'scratchpad -set ast.derive_cache /tmp/cache'),\n");
+		log("the RTLIL generated for parametric modules from the AST frontends is stored\n");
+		log("in that directory and re-used by later runs. The cache key covers the AST of\n");
+		log("the module, the parameter values and the frontend options, but not the\n");
+		log("contents of files read with $readmemh/$readmemb.\n");
+		log("\n");
 		log("In -generate mode this pass generates blackbox modules for the given cell\n");
 		log("types (wildcards supported). For this the design is searched for cells that\n");
 		log("match the given types and then the given port declarations are used to\n");
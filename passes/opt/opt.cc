@@ -18,6 +18,7 @@
  */
 
 #include "kernel/register.h"
+#include "kernel/sigtools.h"
 #include "kernel/log.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -25,6 +26,88 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// Collects the nets that were connected or disconnected while the monitor is installed.
+// Bits are stored by wire name, because opt_clean deletes wires without notifying monitors.
+struct OptMonitor : public RTLIL::Monitor
+{
+	dict<RTLIL::Module*, pool<std::pair<RTLIL::IdString, int>>> touched_bits;
+	pool<RTLIL::Module*> touched_modules;
+
+	void touch(RTLIL::Module *module, const RTLIL::SigSpec &sig)
+	{
+		for (auto &bit : sig)
+			if (bit.wire != nullptr)
+				touched_bits[module].insert(std::make_pair(bit.wire->name, bit.offset));
+	}
+
+	void notify_module_add(RTLIL::Module *module) YS_OVERRIDE
+	{
+		touched_modules.insert(module);
+	}
+
+	void notify_module_del(RTLIL::Module *module) YS_OVERRIDE
+	{
+		touched_modules.erase(module);
+		touched_bits.erase(module);
+	}
+
+	void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString&, const RTLIL::SigSpec &old_sig, RTLIL::SigSpec &sig) YS_OVERRIDE
+	{
+		touch(cell->module, old_sig);
+		touch(cell->module, sig);
+	}
+
+	void notify_connect(RTLIL::Module *module, const RTLIL::SigSig &sigsig) YS_OVERRIDE
+	{
+		touch(module, sigsig.first);
+		touch(module, sigsig.second);
+	}
+
+	void notify_connect(RTLIL::Module *module, const std::vector<RTLIL::SigSig>&) YS_OVERRIDE
+	{
+		touched_modules.insert(module);
+	}
+
+	void notify_blackout(RTLIL::Module *module) YS_OVERRIDE
+	{
+		touched_modules.insert(module);
+	}
+
+	void clear()
+	{
+		touched_bits.clear();
+		touched_modules.clear();
+	}
+
+	// select the cells of a changed module that are connected to a touched net
+	void select_cells(RTLIL::Selection &sel, RTLIL::Module *module)
+	{
+		if (touched_modules.count(module) || !touched_bits.count(module)) {
+			sel.select(module);
+			return;
+		}
+
+		SigMap sigmap(module);
+		pool<RTLIL::SigBit> bits;
+		for (auto &it : touched_bits.at(module)) {
+			RTLIL::Wire *wire = module->wire(it.first);
+			if (wire != nullptr && it.second < GetSize(wire))
+				bits.insert(sigmap(RTLIL::SigBit(wire, it.second)));
+		}
+
+		for (auto cell : module->cells())
+		{
+			for (auto &conn : cell->connections())
+			for (auto bit : sigmap(conn.second))
+				if (bits.count(bit)) {
+					sel.select(module, cell);
+					goto next_cell;
+				}
+		next_cell:;
+		}
+	}
+};
+
 struct OptPass : public Pass {
 	OptPass() : Pass("opt", "perform simple optimizations") { }
 	void help() YS_OVERRIDE
@@ -50,6 +133,16 @@ struct OptPass : public Pass {
 		log("        opt_expr [-mux_undef] [-mux_bool] [-undriven] [-clkinv] [-fine] [-full] [-keepdc]\n");
 		log("    while <changed design>\n");
 		log("\n");
+		log("When 'opt' runs on the whole design, iterations after the first one only\n");
+		log("revisit the modules that were changed by the previous iteration. Within\n");
+		log("those modules, opt_reduce, opt_merge, opt_rmdff and opt_expr only look at\n");
+		log("the cells connected to nets that were changed by the previous iteration.\n");
+		log("Once they have settled, a last iteration over the whole design confirms that\n");
+		log("there is nothing left to do.\n");
+		log("Iterations run on the whole design anyway when the changed modules hold\n");
+		log("almost all cells of the design (e.g. in a flat design), or when more than a\n");
+		log("quarter of the cells are next to changed nets.\n");
+		log("\n");
 		log("When called with -fast the following script is used instead:\n");
 		log("\n");
 		log("    do\n");
@@ -149,20 +242,87 @@ struct OptPass : public Pass {
 		{
 			Pass::call(design, "opt_expr" + opt_expr_args);
 			Pass::call(design, "opt_merge -nomux" + opt_merge_args);
-			while (1) {
-				design->scratchpad_unset("opt.did_something");
-				Pass::call(design, "opt_muxtree");
-				Pass::call(design, "opt_reduce" + opt_reduce_args);
-				Pass::call(design, "opt_merge" + opt_merge_args);
-				if (opt_share)
-					Pass::call(design, "opt_share");
-				Pass::call(design, "opt_rmdff" + opt_rmdff_args);
-				Pass::call(design, "opt_clean" + opt_clean_args);
-				Pass::call(design, "opt_expr" + opt_expr_args);
-				if (design->scratchpad_get_bool("opt.did_something") == false)
-					break;
-				log_header(design, "Rerunning OPT passes. (Maybe there is more to do..)\n");
+
+			bool use_worklist = design->full_selection();
+			bool full_iteration = true;
+			RTLIL::Selection worklist(false), cell_worklist(false);
+			dict<RTLIL::Module*, unsigned int> last_changes;
+			OptMonitor monitor;
+
+			// opt_muxtree, opt_share and opt_clean need whole modules, the other
+			// passes only look at the cells next to the nets changed last time
+			auto call = [&](std::string command, bool cells) {
+				if (full_iteration)
+					Pass::call(design, command);
+				else if (!cells)
+					Pass::call_on_selection(design, worklist, command);
+				else if (!cell_worklist.empty())
+					Pass::call_on_selection(design, cell_worklist, command);
+			};
+
+			if (use_worklist)
+				design->monitors.insert(&monitor);
+
+			try {
+				while (1) {
+					design->scratchpad_unset("opt.did_something");
+					last_changes.clear();
+					for (auto module : design->modules())
+						last_changes[module] = module->changes();
+					monitor.clear();
+					call("opt_muxtree", false);
+					call("opt_reduce" + opt_reduce_args, true);
+					call("opt_merge" + opt_merge_args, true);
+					if (opt_share)
+						call("opt_share", false);
+					call("opt_rmdff" + opt_rmdff_args, true);
+					call("opt_clean" + opt_clean_args, false);
+					call("opt_expr" + opt_expr_args, true);
+					if (design->scratchpad_get_bool("opt.did_something") == false) {
+						if (full_iteration)
+							break;
+						full_iteration = true;
+						log_header(design, "Rerunning OPT passes on the whole design. (Checking if there is more to do..)\n");
+						continue;
+					}
+					// Changes that bypass the module API (e.g. a cell type rewritten
+					// in place) leave the worklist empty: fall back to the whole design.
+					worklist = RTLIL::Selection(false);
+					cell_worklist = RTLIL::Selection(false);
+					int total_cells = 0, changed_cells = 0, cell_count = 0;
+					for (auto module : design->modules()) {
+						total_cells += GetSize(module->cells_);
+						if (last_changes.count(module) == 0 || last_changes.at(module) != module->changes()) {
+							worklist.select(module);
+							changed_cells += GetSize(module->cells_);
+							if (use_worklist)
+								monitor.select_cells(cell_worklist, module);
+						}
+					}
+					for (auto module : design->modules()) {
+						if (cell_worklist.selected_whole_module(module->name))
+							cell_count += GetSize(module->cells_);
+						else if (cell_worklist.selected_members.count(module->name))
+							cell_count += GetSize(cell_worklist.selected_members.at(module->name));
+					}
+					// opt_muxtree and opt_clean still scan the changed modules as a whole, and the
+					// passes restricted to the cell worklist pay for the selection. Neither pays
+					// off when (almost) the whole design changed, e.g. in a flat design, or when
+					// a large part of the cells is next to a changed net.
+					full_iteration = !use_worklist || worklist.empty() || 8*changed_cells > 7*total_cells || 4*cell_count > total_cells;
+					if (full_iteration) {
+						log_header(design, "Rerunning OPT passes. (Maybe there is more to do..)\n");
+					} else {
+						log_header(design, "Rerunning OPT passes on %d changed modules (%d cells next to changed nets). (Maybe there is more to do..)\n",
+								GetSize(worklist.selected_modules), cell_count);
+					}
+				}
+			} catch (...) {
+				design->monitors.erase(&monitor);
+				throw;
 			}
+
+			design->monitors.erase(&monitor);
 		}
 
 		design->optimize();
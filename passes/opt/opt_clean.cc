@@ -281,7 +281,11 @@ bool rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool verbos
 		}
 	}
 
-	module->connections_.clear();
+	// The connections are rebuilt below. Only replace them (and count that as a change of
+	// the module, see 'opt') when they actually differ from the current ones.
+	std::vector<RTLIL::SigSig> old_connections;
+	std::swap(old_connections, module->connections_);
+	std::vector<RTLIL::SigSig> new_connections;
 
 	SigPool used_signals;
 	SigPool raw_used_signals;
@@ -289,7 +293,9 @@ bool rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool verbos
 	for (auto &it : module->cells_) {
 		RTLIL::Cell *cell = it.second;
 		for (auto &it2 : cell->connections_) {
-			assign_map.apply(it2.second);
+			RTLIL::SigSpec sig = assign_map(it2.second);
+			if (sig != it2.second)
+				cell->setPort(it2.first, sig);
 			raw_used_signals.add(it2.second);
 			used_signals.add(it2.second);
 			if (!ct_all.cell_output(cell->type, it2.first))
@@ -371,7 +377,7 @@ bool rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool verbos
 					wire->attributes.at(ID(init)) = initval;
 				used_signals.add(new_conn.first);
 				used_signals.add(new_conn.second);
-				module->connect(new_conn);
+				new_connections.push_back(new_conn);
 			}
 
 			if (!used_signals_nodrivers.check_all(s2)) {
@@ -395,6 +401,12 @@ bool rmunused_module_signals(RTLIL::Module *module, bool purge_mode, bool verbos
 		}
 	}
 
+	if (new_connections == old_connections)
+		std::swap(old_connections, module->connections_);
+	else
+		for (auto &conn : new_connections)
+			module->connect(conn);
+
 	int del_temp_wires_count = 0;
 	for (auto wire : del_wires_queue) {
 		if (ys_debug() || (check_public_name(wire->name) && verbose))
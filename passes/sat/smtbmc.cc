@@ -0,0 +1,477 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Clifford Wolf <clifford@clifford.at>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <signal.h>
+extern char **environ;
+#endif
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+// metadata from the "; yosys-smt2-*" comments of one module in the write_smt2 output
+struct SmtModInfo
+{
+	std::vector<std::pair<std::string, int>> inputs;
+	std::vector<std::pair<std::string, std::string>> asserts;
+	std::vector<std::pair<std::string, std::string>> cells;
+};
+
+#ifndef _WIN32
+
+// An SMT-LIBv2 solver running in a subprocess. Statements are collected in a
+// buffer and only sent when a response is needed, so that the statements of a
+// whole step go to the solver in one write.
+struct SmtSolver
+{
+	std::vector<std::string> command;
+	std::string sendbuf, recvbuf;
+	std::ofstream dump_f;
+	int fdsend = -1, fdrecv = -1;
+	pid_t pid = -1;
+	struct sigaction old_sigpipe;
+
+	void start()
+	{
+		std::vector<char*> argv;
+		for (auto &arg : command)
+			argv.push_back(&arg[0]);
+		argv.push_back(nullptr);
+
+		int send[2], recv[2];
+		if (pipe(send) != 0 || pipe(recv) != 0)
+			log_cmd_error("pipe failed: %s\n", strerror(errno));
+
+		posix_spawn_file_actions_t file_actions;
+		posix_spawn_file_actions_init(&file_actions);
+		posix_spawn_file_actions_adddup2(&file_actions, send[0], STDIN_FILENO);
+		posix_spawn_file_actions_addclose(&file_actions, send[1]);
+		posix_spawn_file_actions_adddup2(&file_actions, recv[1], STDOUT_FILENO);
+		posix_spawn_file_actions_addclose(&file_actions, recv[0]);
+
+		int spawn_result = posix_spawnp(&pid, argv[0], &file_actions, nullptr, argv.data(), environ);
+		posix_spawn_file_actions_destroy(&file_actions);
+		close(send[0]);
+		close(recv[1]);
+
+		if (spawn_result != 0) {
+			close(send[1]);
+			close(recv[0]);
+			log_cmd_error("Failed to start SMT solver `%s': %s\n", command.front().c_str(), strerror(spawn_result));
+		}
+
+		fdsend = send[1];
+		fdrecv = recv[0];
+
+		// writing to a solver that has terminated must not kill us with SIGPIPE,
+		// the write fails with EPIPE instead
+		struct sigaction sa;
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = SIG_IGN;
+		sigaction(SIGPIPE, &sa, &old_sigpipe);
+	}
+
+	void terminated()
+	{
+		::waitpid(pid, nullptr, 0);
+		pid = -1;
+		sigaction(SIGPIPE, &old_sigpipe, nullptr);
+		log_error("SMT solver `%s' terminated unexpectedly.\n", command.front().c_str());
+	}
+
+	void write(const std::string &stmt)
+	{
+		sendbuf += stmt;
+		sendbuf += '\n';
+		if (dump_f.is_open())
+			dump_f << stmt << '\n';
+	}
+
+	void flush()
+	{
+		size_t offset = 0;
+		while (offset < sendbuf.size()) {
+			ssize_t result = ::write(fdsend, sendbuf.data() + offset, sendbuf.size() - offset);
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result < 0 && errno == EPIPE)
+				terminated();
+			if (result < 0)
+				log_error("Writing to SMT solver failed: %s\n", strerror(errno));
+			offset += result;
+		}
+		sendbuf.clear();
+	}
+
+	// returns the length of the first complete response in recvbuf, or 0
+	size_t complete_response()
+	{
+		size_t i = 0;
+		while (i < recvbuf.size() && isspace(recvbuf[i]))
+			i++;
+		if (i == recvbuf.size())
+			return 0;
+
+		if (recvbuf[i] != '(') {
+			size_t end = recvbuf.find('\n', i);
+			return end == std::string::npos ? 0 : end + 1;
+		}
+
+		int depth = 0;
+		for (; i < recvbuf.size(); i++) {
+			char ch = recvbuf[i];
+			if (ch == '|' || ch == '"') {
+				size_t end = recvbuf.find(ch, i+1);
+				if (end == std::string::npos)
+					return 0;
+				i = end;
+			} else if (ch == '(') {
+				depth++;
+			} else if (ch == ')') {
+				if (--depth == 0)
+					return i + 1;
+			}
+		}
+		return 0;
+	}
+
+	std::string read()
+	{
+		flush();
+
+		size_t len;
+		while ((len = complete_response()) == 0) {
+			char buffer[4096];
+			ssize_t result = ::read(fdrecv, buffer, sizeof(buffer));
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result < 0)
+				log_error("Reading from SMT solver failed: %s\n", strerror(errno));
+			if (result == 0)
+				terminated();
+			recvbuf.append(buffer, result);
+		}
+
+		std::string response = recvbuf.substr(0, len);
+		recvbuf.erase(0, len);
+
+		size_t first = response.find_first_not_of(" \t\r\n");
+		size_t last = response.find_last_not_of(" \t\r\n");
+		return response.substr(first, last - first + 1);
+	}
+
+	std::string check_sat()
+	{
+		write("(check-sat)");
+		std::string response = read();
+		if (response != "sat" && response != "unsat")
+			log_error("Unexpected response from SMT solver: %s\n", response.c_str());
+		return response;
+	}
+
+	// returns the value of expr in the current model, as a string of '0' and '1' (MSB first)
+	std::string get_value(const std::string &expr)
+	{
+		write("(get-value (" + expr + "))");
+		std::string response = read();
+
+		size_t end = response.find_last_not_of(") \t\r\n");
+		size_t begin = response.find_last_of(" \t\r\n(", end);
+		if (end == std::string::npos || begin == std::string::npos)
+			log_error("Unexpected response from SMT solver: %s\n", response.c_str());
+		std::string value = response.substr(begin + 1, end - begin);
+
+		if (value == "true")
+			return "1";
+		if (value == "false")
+			return "0";
+		if (value.compare(0, 2, "#b") == 0)
+			return value.substr(2);
+		if (value.compare(0, 2, "#x") == 0) {
+			std::string bits;
+			for (size_t i = 2; i < value.size(); i++) {
+				int digit = isdigit(value[i]) ? value[i] - '0' : tolower(value[i]) - 'a' + 10;
+				for (int k = 3; k >= 0; k--)
+					bits += (digit >> k) & 1 ? '1' : '0';
+			}
+			return bits;
+		}
+
+		log_error("Unexpected value from SMT solver: %s\n", response.c_str());
+	}
+
+	void stop()
+	{
+		if (pid != -1) {
+			write("(exit)");
+			flush();
+		}
+		close(fdsend);
+		close(fdrecv);
+		if (pid != -1)
+			::waitpid(pid, nullptr, 0);
+		sigaction(SIGPIPE, &old_sigpipe, nullptr);
+	}
+};
+
+#endif
+
+struct SmtBmcPass : public Pass {
+	SmtBmcPass() : Pass("smtbmc", "bounded model checking with an SMT solver") { }
+	void help() YS_OVERRIDE
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    smtbmc [options]\n");
+		log("\n");
+		log("Run bounded model checking of the assertions in the top module (and the modules\n");
+		log("below it) with an SMT solver. This implements the basic BMC mode of\n");
+		log("yosys-smtbmc: the design is exported with 'write_smt2', the unrolled transition\n");
+		log("relation is sent to the solver step by step, and the assertions of each step\n");
+		log("are checked in a (push 1) / (pop 1) block on top of the previous steps.\n");
+		log("\n");
+		log("When an assertion fails, the failing assertions and the values of the inputs of\n");
+		log("the top module in each step of the counterexample are printed.\n");
+		log("\n");
+		log("    -s <solver>\n");
+		log("        the SMT solver to use: yices (default), z3, cvc4 or mathsat. The solver\n");
+		log("        is started as a subprocess and must be in PATH.\n");
+		log("\n");
+		log("    -S <opt>\n");
+		log("        pass an additional command line option to the solver.\n");
+		log("\n");
+		log("    -t <num_steps>\n");
+		log("        number of steps to check (default: 20).\n");
+		log("\n");
+		log("    -skip <num_steps>\n");
+		log("        do not check the assertions in the first <num_steps> steps.\n");
+		log("\n");
+		log("    -dump-smt2 <filename>\n");
+		log("        write all statements sent to the solver to the given file.\n");
+		log("\n");
+		log("    -verify\n");
+		log("        return an error when an assertion fails.\n");
+		log("\n");
+		log("Temporal induction, cover statements, constraint files and witness/VCD output\n");
+		log("are only available in yosys-smtbmc.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
+	{
+		std::string solver = "yices";
+		std::vector<std::string> solver_opts;
+		std::string dump_filename;
+		int num_steps = 20;
+		int skip_steps = 0;
+		bool verify = false;
+
+		log_header(design, "Executing SMTBMC pass (bounded model checking with an SMT solver).\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-s" && argidx+1 < args.size()) {
+				solver = args[++argidx];
+				continue;
+			}
+			if (args[argidx] == "-S" && argidx+1 < args.size()) {
+				solver_opts.push_back(args[++argidx]);
+				continue;
+			}
+			if (args[argidx] == "-t" && argidx+1 < args.size()) {
+				num_steps = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-skip" && argidx+1 < args.size()) {
+				skip_steps = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-dump-smt2" && argidx+1 < args.size()) {
+				dump_filename = args[++argidx];
+				continue;
+			}
+			if (args[argidx] == "-verify") {
+				verify = true;
+				continue;
+			}
+			break;
+		}
+		extra_args(args, argidx, design);
+
+#ifdef _WIN32
+		log_cmd_error("The smtbmc command is not supported on Windows, use yosys-smtbmc instead.\n");
+#else
+		std::vector<std::string> command;
+		if (solver == "yices")
+			command = {"yices-smt2", "--incremental"};
+		else if (solver == "z3")
+			command = {"z3", "-smt2", "-in"};
+		else if (solver == "cvc4")
+			command = {"cvc4", "--incremental", "--lang", "smt2"};
+		else if (solver == "mathsat")
+			command = {"mathsat"};
+		else
+			log_cmd_error("Unsupported SMT solver `%s'.\n", solver.c_str());
+		command.insert(command.end(), solver_opts.begin(), solver_opts.end());
+
+		std::stringstream smt2_buf;
+		Backend::backend_call(design, &smt2_buf, "<smtbmc>", "smt2");
+
+		// collect the metadata and the statements from the write_smt2 output
+		dict<std::string, SmtModInfo> modinfo;
+		std::string topmod, curmod, statements;
+		bool logic_ax = true, logic_bv = true, logic_dt = false;
+
+		std::string line;
+		while (std::getline(smt2_buf, line))
+		{
+			if (line.compare(0, 13, "; yosys-smt2-") != 0) {
+				if (!line.empty() && line[0] != ';')
+					statements += line + "\n";
+				continue;
+			}
+
+			std::vector<std::string> fields = split_tokens(line);
+			if (GetSize(fields) < 2)
+				continue;
+
+			if (fields[1] == "yosys-smt2-nomem")
+				logic_ax = false;
+			if (fields[1] == "yosys-smt2-nobv")
+				logic_bv = false;
+			if (fields[1] == "yosys-smt2-stdt")
+				logic_dt = true;
+			if (fields[1] == "yosys-smt2-module" && GetSize(fields) > 2)
+				curmod = fields[2];
+			if (fields[1] == "yosys-smt2-topmod" && GetSize(fields) > 2)
+				topmod = fields[2];
+			if (fields[1] == "yosys-smt2-input" && GetSize(fields) > 3)
+				modinfo[curmod].inputs.push_back(std::make_pair(fields[2], atoi(fields[3].c_str())));
+			if (fields[1] == "yosys-smt2-assert" && GetSize(fields) > 2)
+				modinfo[curmod].asserts.push_back(std::make_pair(fields[2], GetSize(fields) > 3 ? fields[3] : fields[2]));
+			if (fields[1] == "yosys-smt2-cell" && GetSize(fields) > 3)
+				modinfo[curmod].cells.push_back(std::make_pair(fields[2], fields[3]));
+		}
+
+		if (topmod.empty())
+			log_cmd_error("No top module found, run 'hierarchy -top <module>' first.\n");
+
+		std::string logic = logic_dt ? "ALL" : std::string("QF_") + (logic_ax ? "A" : "") + "UF" + (logic_bv ? "BV" : "");
+
+		SmtSolver smt;
+		smt.command = command;
+		if (!dump_filename.empty()) {
+			smt.dump_f.open(dump_filename.c_str());
+			if (smt.dump_f.fail())
+				log_cmd_error("Can't open file `%s' for writing: %s\n", dump_filename.c_str(), strerror(errno));
+		}
+
+		std::string command_str;
+		for (auto &arg : command)
+			command_str += (command_str.empty() ? "" : " ") + arg;
+		log("Starting SMT solver: %s\n", command_str.c_str());
+		smt.start();
+
+		smt.write("(set-option :produce-models true)");
+		smt.write("(set-logic " + logic + ")");
+		smt.write(statements);
+
+		int failed_step = -1;
+		for (int step = 0; step < num_steps; step++)
+		{
+			smt.write(stringf("(declare-fun s%d () |%s_s|)", step, topmod.c_str()));
+			smt.write(stringf("(assert (|%s_u| s%d))", topmod.c_str(), step));
+			smt.write(stringf("(assert (|%s_h| s%d))", topmod.c_str(), step));
+
+			if (step == 0) {
+				smt.write(stringf("(assert (|%s_i| s0))", topmod.c_str()));
+				smt.write(stringf("(assert (|%s_is| s0))", topmod.c_str()));
+			} else {
+				smt.write(stringf("(assert (|%s_t| s%d s%d))", topmod.c_str(), step-1, step));
+				smt.write(stringf("(assert (not (|%s_is| s%d)))", topmod.c_str(), step));
+			}
+
+			if (step < skip_steps) {
+				log("Skipping step %d..\n", step);
+				continue;
+			}
+
+			log("Checking assertions in step %d..\n", step);
+			smt.write("(push 1)");
+			smt.write(stringf("(assert (not (|%s_a| s%d)))", topmod.c_str(), step));
+
+			if (smt.check_sat() == "sat") {
+				failed_step = step;
+				break;
+			}
+
+			smt.write("(pop 1)");
+			if (step+1 < num_steps)
+				smt.write(stringf("(assert (|%s_a| s%d))", topmod.c_str(), step));
+		}
+
+		if (failed_step >= 0)
+		{
+			log("\n");
+			log("BMC failed in step %d!\n", failed_step);
+
+			// report the failed assertions in the whole hierarchy
+			std::vector<std::tuple<std::string, std::string, std::string>> worklist;
+			worklist.push_back(std::make_tuple(topmod, stringf("s%d", failed_step), topmod));
+			while (!worklist.empty()) {
+				std::string mod, state, path;
+				std::tie(mod, state, path) = worklist.back();
+				worklist.pop_back();
+				if (modinfo.count(mod) == 0)
+					continue;
+				for (auto &it : modinfo.at(mod).asserts)
+					if (smt.get_value(stringf("(|%s_a %s| %s)", mod.c_str(), it.first.c_str(), state.c_str())) == "0")
+						log("  Assert failed in %s: %s\n", path.c_str(), it.second.c_str());
+				for (auto &it : modinfo.at(mod).cells)
+					worklist.push_back(std::make_tuple(it.first, stringf("(|%s_h %s| %s)", mod.c_str(), it.second.c_str(), state.c_str()),
+							path + "." + it.second));
+			}
+
+			log("\n");
+			log("Values of the inputs of %s in the counterexample:\n", topmod.c_str());
+			for (int step = 0; step <= failed_step; step++)
+				for (auto &it : modinfo[topmod].inputs) {
+					std::string value = smt.get_value(stringf("(|%s_n %s| s%d)", topmod.c_str(), it.first.c_str(), step));
+					log("  step %3d: %s = %d'b%s\n", step, it.first.c_str(), GetSize(value), value.c_str());
+				}
+		}
+
+		smt.stop();
+
+		if (failed_step >= 0) {
+			if (verify)
+				log_error("BMC failed in step %d.\n", failed_step);
+		} else {
+			log("\n");
+			log("No assertion failed in %d steps.\n", num_steps);
+		}
+#endif
+	}
+} SmtBmcPass;
+
+PRIVATE_NAMESPACE_END
@@ -564,6 +564,17 @@ struct DfflibmapPass : public Pass {
 		log("to the internal cell types that best match the cells found in the given\n");
 		log("liberty file.\n");
 		log("\n");
+		log("When the scratchpad variable 'libparse.cache' is set, the parsed liberty\n");
+		log("file is kept in memory and re-used by later dfflibmap and stat commands\n");
+		log("using the same (unmodified) file. A file is considered unmodified if its\n");
+		log("modification time (in seconds) and size did not change, so a change that\n");
+		log("keeps both is not detected. The cached data is dropped by the next command\n");
+		log("that runs with the scratchpad variable unset, and at exit.\n");
+		log("\n");
+	}
+	void on_shutdown() YS_OVERRIDE
+	{
+		LibertyAstCache::instance.clear();
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
@@ -592,33 +603,28 @@ struct DfflibmapPass : public Pass {
 		if (liberty_file.empty())
 			log_cmd_error("Missing `-liberty liberty_file' option!\n");
 
-		std::ifstream f;
-		f.open(liberty_file.c_str());
-		if (f.fail())
-			log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-		LibertyParser libparser(f);
-		f.close();
-
-		find_cell(libparser.ast, ID($_DFF_N_), false, false, false, false, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_P_), true, false, false, false, prepare_mode);
-
-		find_cell(libparser.ast, ID($_DFF_NN0_), false, true, false, false, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_NN1_), false, true, false, true, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_NP0_), false, true, true, false, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_NP1_), false, true, true, true, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_PN0_), true, true, false, false, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_PN1_), true, true, false, true, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_PP0_), true, true, true, false, prepare_mode);
-		find_cell(libparser.ast, ID($_DFF_PP1_), true, true, true, true, prepare_mode);
-
-		find_cell_sr(libparser.ast, ID($_DFFSR_NNN_), false, false, false, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_NNP_), false, false, true, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_NPN_), false, true, false, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_NPP_), false, true, true, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_PNN_), true, false, false, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_PNP_), true, false, true, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_PPN_), true, true, false, prepare_mode);
-		find_cell_sr(libparser.ast, ID($_DFFSR_PPP_), true, true, true, prepare_mode);
+		std::shared_ptr<LibertyAst> libast = LibertyAstCache::instance.parse(liberty_file, design->scratchpad_get_bool("libparse.cache"));
+
+		find_cell(libast.get(), ID($_DFF_N_), false, false, false, false, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_P_), true, false, false, false, prepare_mode);
+
+		find_cell(libast.get(), ID($_DFF_NN0_), false, true, false, false, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_NN1_), false, true, false, true, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_NP0_), false, true, true, false, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_NP1_), false, true, true, true, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_PN0_), true, true, false, false, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_PN1_), true, true, false, true, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_PP0_), true, true, true, false, prepare_mode);
+		find_cell(libast.get(), ID($_DFF_PP1_), true, true, true, true, prepare_mode);
+
+		find_cell_sr(libast.get(), ID($_DFFSR_NNN_), false, false, false, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_NNP_), false, false, true, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_NPN_), false, true, false, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_NPP_), false, true, true, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_PNN_), true, false, false, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_PNP_), true, false, true, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_PPN_), true, true, false, prepare_mode);
+		find_cell_sr(libast.get(), ID($_DFFSR_PPP_), true, true, true, prepare_mode);
 
 		// try to implement as many cells as possible just by inverting
 		// the SET and RESET pins. If necessary, implement cell types
@@ -28,6 +28,7 @@
 
 #ifndef FILTERLIB
 #include "kernel/log.h"
+#include <sys/stat.h>
 #endif
 
 using namespace Yosys;
@@ -85,24 +86,28 @@ void LibertyAst::dump(FILE *f, std::string indent, std::string path, bool path_o
 
 int LibertyParser::lexer(std::string &str)
 {
+	// read from the stream buffer directly, going through std::istream::get()
+	// for every single character is a major part of the runtime for large files
+	std::streambuf *sb = f.rdbuf();
 	int c;
 
 	// eat whitespace
 	do {
-		c = f.get();
+		c = sb->sbumpc();
 	} while (c == ' ' || c == '\t' || c == '\r');
 
 	// search for identifiers, numbers, plus or minus.
 	if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.') {
-		str = static_cast<char>(c);
+		str.clear();
+		str += static_cast<char>(c);
 		while (1) {
-			c = f.get();
+			c = sb->sgetc();
 			if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.')
 				str += c;
 			else
 				break;
+			sb->sbumpc();
 		}
-		f.unget();
 		if (str == "+" || str == "-") {
 			/* Single operator is not an identifier */
 			// fprintf(stderr, "LEX: char >>%s<<\n", str.c_str());
@@ -117,12 +122,12 @@ int LibertyParser::lexer(std::string &str)
 	// if it wasn't an identifer, number of array range,
 	// maybe it's a string?
 	if (c == '"') {
-		str = "";
+		str.clear();
 		while (1) {
-			c = f.get();
+			c = sb->sbumpc();
 			if (c == '\n')
 				line++;
-			if (c == '"')
+			if (c == '"' || c == EOF)
 				break;
 			str += c;
 		}
@@ -132,37 +137,40 @@ int LibertyParser::lexer(std::string &str)
 
 	// if it wasn't a string, perhaps it's a comment or a forward slash?
 	if (c == '/') {
-		c = f.get();
+		c = sb->sgetc();
 		if (c == '*') {         // start of '/*' block comment
+			sb->sbumpc();
 			int last_c = 0;
 			while (c > 0 && (last_c != '*' || c != '/')) {
 				last_c = c;
-				c = f.get();
+				c = sb->sbumpc();
 				if (c == '\n')
 					line++;
 			}
 			return lexer(str);
 		} else if (c == '/') {  // start of '//' line comment
+			sb->sbumpc();
 			while (c > 0 && c != '\n')
-				c = f.get();
+				c = sb->sbumpc();
 			line++;
 			return lexer(str);
 		}
-		f.unget();
 		// fprintf(stderr, "LEX: char >>/<<\n");
 		return '/';             // a single '/' charater.
 	}
 
 	// check for a backslash
 	if (c == '\\') {
-		c = f.get();		
-		if (c == '\r')
-			c = f.get();
+		c = sb->sgetc();
+		if (c == '\r') {
+			sb->sbumpc();
+			c = sb->sgetc();
+		}
 		if (c == '\n') {
+			sb->sbumpc();
 			line++;
 			return lexer(str);
 		}
-		f.unget();
 		return '\\';
 	}
 
@@ -337,10 +345,18 @@ LibertyAst *LibertyParser::parse()
 		}
 
 		if (tok == '{') {
+			if (skip_cell(ast)) {
+				skip_group();
+				break;
+			}
 			while (1) {
 				LibertyAst *child = parse();
 				if (child == NULL)
 					break;
+				if (skip_cell(child)) {
+					delete child;
+					continue;
+				}
 				ast->children.push_back(child);
 			}
 			break;
@@ -352,6 +368,57 @@ LibertyAst *LibertyParser::parse()
 	return ast;
 }
 
+bool LibertyParser::skip_cell(LibertyAst *ast)
+{
+	return cell_filter && ast->id == "cell" && ast->args.size() == 1 && !cell_filter(ast->args[0]);
+}
+
+// skip to the '}' matching an already consumed '{'
+void LibertyParser::skip_group()
+{
+	std::streambuf *sb = f.rdbuf();
+	int depth = 1;
+
+	while (depth > 0)
+	{
+		int c = sb->sbumpc();
+
+		switch (c)
+		{
+		case EOF:
+			error("Unexpected end of file.");
+			return;
+		case '\n':
+			line++;
+			break;
+		case '{':
+			depth++;
+			break;
+		case '}':
+			depth--;
+			break;
+		case '"':
+			while ((c = sb->sbumpc()) != '"' && c != EOF)
+				if (c == '\n')
+					line++;
+			break;
+		case '/':
+			if (sb->sgetc() == '*') {
+				int last_c = sb->sbumpc();
+				while ((c = sb->sbumpc()) != EOF && (last_c != '*' || c != '/')) {
+					if (c == '\n')
+						line++;
+					last_c = c;
+				}
+			} else if (sb->sgetc() == '/') {
+				while ((c = sb->sgetc()) != EOF && c != '\n')
+					sb->sbumpc();
+			}
+			break;
+		}
+	}
+}
+
 #ifndef FILTERLIB
 
 void LibertyParser::error()
@@ -367,6 +434,40 @@ void LibertyParser::error(const std::string &str)
 	log_error("%s", ss.str().c_str());
 }
 
+LibertyAstCache LibertyAstCache::instance;
+
+std::shared_ptr<LibertyAst> LibertyAstCache::parse(const std::string &fname, bool use_cache)
+{
+	struct stat st;
+	if (stat(fname.c_str(), &st) != 0)
+		log_cmd_error("Can't open liberty file `%s': %s\n", fname.c_str(), strerror(errno));
+	std::string stamp = stringf("%lld %lld", (long long)st.st_mtime, (long long)st.st_size);
+
+	if (use_cache) {
+		auto it = cached.find(fname);
+		if (it != cached.end() && it->second.first == stamp) {
+			log("Using cached data for liberty file `%s'.\n", fname.c_str());
+			return it->second.second;
+		}
+	}
+
+	std::ifstream f;
+	f.open(fname.c_str());
+	if (f.fail())
+		log_cmd_error("Can't open liberty file `%s': %s\n", fname.c_str(), strerror(errno));
+
+	LibertyParser parser(f);
+	std::shared_ptr<LibertyAst> ast(parser.ast);
+	parser.ast = nullptr;
+
+	if (use_cache)
+		cached[fname] = std::make_pair(stamp, ast);
+	else
+		clear();
+
+	return ast;
+}
+
 #else
 
 void LibertyParser::error()
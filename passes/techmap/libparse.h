@@ -24,6 +24,9 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
+#include <memory>
+#include <functional>
 
 namespace Yosys
 {
@@ -43,8 +46,15 @@ namespace Yosys
 	{
 		std::istream &f;
 		int line;
+
+		// when set, the bodies of cell groups for which this returns false are skipped
+		// without building an AST for them
+		std::function<bool(const std::string&)> cell_filter;
+
 		LibertyAst *ast;
 		LibertyParser(std::istream &f) : f(f), line(1), ast(parse()) {}
+		LibertyParser(std::istream &f, std::function<bool(const std::string&)> cell_filter) :
+				f(f), line(1), cell_filter(cell_filter), ast(parse()) {}
 		~LibertyParser() { if (ast) delete ast; }
         
         /* lexer return values:
@@ -55,9 +65,29 @@ namespace Yosys
 		int lexer(std::string &str);
 		
         LibertyAst *parse();
+		bool skip_cell(LibertyAst *ast);
+		void skip_group();
 		void error();
         void error(const std::string &str);
 	};
+
+	// In-process cache of parsed liberty files, keyed by file name, modification
+	// time and size, so that passes that are run with the same -liberty file several times in
+	// a flow (dfflibmap, stat, ..) only parse it once.
+	struct LibertyAstCache
+	{
+		LibertyAstCache() {}
+		~LibertyAstCache() {}
+
+		// parse the liberty file, or return the AST from an earlier call. if use_cache is
+		// false the file is always parsed and all cached data is dropped.
+		std::shared_ptr<LibertyAst> parse(const std::string &fname, bool use_cache);
+
+		void clear() { cached.clear(); }
+
+		std::map<std::string, std::pair<std::string, std::shared_ptr<LibertyAst>>> cached;
+		static LibertyAstCache instance;
+	};
 }
 
 #endif
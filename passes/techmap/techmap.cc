@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "simplemap.h"
 #include "passes/techmap/techmap.inc"
@@ -60,6 +61,32 @@ void apply_prefix(IdString prefix, RTLIL::SigSpec &sig, RTLIL::Module *module)
 	sig = chunks;
 }
 
+// Map files parsed by earlier techmap calls (only used when the scratchpad variable
+// "techmap.cache" is set). The key is built from the frontend command, the map file
+// names and their modification times and sizes. The cached modules are never used
+// directly, techmap adds derived templates to the map design, so every call works on
+// clones of them.
+static dict<std::string, RTLIL::Design*> techmap_map_cache;
+
+static std::string techmap_map_cache_key(const std::vector<std::string> &map_files, const std::string &verilog_frontend)
+{
+	std::string key = verilog_frontend;
+	for (auto &fn : map_files) {
+		struct stat st;
+		if (fn.compare(0, 1, "%") == 0 || stat(fn.c_str(), &st) != 0)
+			return std::string();
+		key += stringf("\n%s\n%lld %lld", fn.c_str(), (long long)st.st_mtime, (long long)st.st_size);
+	}
+	return key;
+}
+
+static void techmap_map_cache_clear()
+{
+	for (auto &it : techmap_map_cache)
+		delete it.second;
+	techmap_map_cache.clear();
+}
+
 struct TechmapWorker
 {
 	std::map<RTLIL::IdString, void(*)(RTLIL::Module*, RTLIL::Cell*)> simplemap_mappers;
@@ -1218,6 +1245,19 @@ struct TechmapPass : public Pass {
 		log("See 'help flatten' for a pass that does flatten the design (which is\n");
 		log("essentially techmap but using the design itself as map library).\n");
 		log("\n");
+		log("When the scratchpad variable 'techmap.cache' is set, the modules parsed from\n");
+		log("-map files are kept in memory and re-used by later techmap calls with the same\n");
+		log("map files and options. A map file is considered unmodified if its modification\n");
+		log("time (in seconds) and size did not change. Changes that keep both, and changes\n");
+		log("in files pulled in with `include, are not detected. The cached modules are\n");
+		log("dropped by the next techmap call that runs with the variable unset, and at exit.\n");
+		log("Script passes (e.g. synth_*) set the variable while they run, unless it is\n");
+		log("already set. Use 'scratchpad -set techmap.cache 0' to disable the cache there.\n");
+		log("\n");
+	}
+	void on_shutdown() YS_OVERRIDE
+	{
+		techmap_map_cache_clear();
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
@@ -1273,29 +1313,52 @@ struct TechmapPass : public Pass {
 		}
 		extra_args(args, argidx, design);
 
+		for (auto &fn : map_files)
+			if (fn.compare(0, 1, "%") != 0) {
+				rewrite_filename(fn);
+				yosys_input_files.insert(fn);
+			}
+
+		std::string map_cache_key;
+		if (design->scratchpad_get_bool("techmap.cache"))
+			map_cache_key = techmap_map_cache_key(map_files, verilog_frontend);
+		else
+			techmap_map_cache_clear();
+
 		RTLIL::Design *map = new RTLIL::Design;
-		if (map_files.empty()) {
-			std::istringstream f(stdcells_code);
-			Frontend::frontend_call(map, &f, "<techmap.v>", verilog_frontend);
+		if (!map_cache_key.empty() && techmap_map_cache.count(map_cache_key)) {
+			log("Using map modules cached from an earlier techmap call.\n");
+			for (auto mod : techmap_map_cache.at(map_cache_key)->modules())
+				map->add(mod->clone());
 		} else {
-			for (auto &fn : map_files)
-				if (fn.compare(0, 1, "%") == 0) {
-					if (!saved_designs.count(fn.substr(1))) {
-						delete map;
-						log_cmd_error("Can't saved design `%s'.\n", fn.c_str()+1);
+			if (map_files.empty()) {
+				std::istringstream f(stdcells_code);
+				Frontend::frontend_call(map, &f, "<techmap.v>", verilog_frontend);
+			} else {
+				for (auto &fn : map_files)
+					if (fn.compare(0, 1, "%") == 0) {
+						if (!saved_designs.count(fn.substr(1))) {
+							delete map;
+							log_cmd_error("Can't saved design `%s'.\n", fn.c_str()+1);
+						}
+						for (auto mod : saved_designs.at(fn.substr(1))->modules())
+							if (!map->has(mod->name))
+								map->add(mod->clone());
+					} else {
+						std::ifstream f;
+						f.open(fn.c_str());
+						if (f.fail())
+							log_cmd_error("Can't open map file `%s'\n", fn.c_str());
+						Frontend::frontend_call(map, &f, fn, (fn.size() > 3 && fn.compare(fn.size()-3, std::string::npos, ".il") == 0 ? "ilang" : verilog_frontend));
 					}
-					for (auto mod : saved_designs.at(fn.substr(1))->modules())
-						if (!map->has(mod->name))
-							map->add(mod->clone());
-				} else {
-					std::ifstream f;
-					rewrite_filename(fn);
-					f.open(fn.c_str());
-					yosys_input_files.insert(fn);
-					if (f.fail())
-						log_cmd_error("Can't open map file `%s'\n", fn.c_str());
-					Frontend::frontend_call(map, &f, fn, (fn.size() > 3 && fn.compare(fn.size()-3, std::string::npos, ".il") == 0 ? "ilang" : verilog_frontend));
-				}
+			}
+
+			if (!map_cache_key.empty()) {
+				RTLIL::Design *cached_map = new RTLIL::Design;
+				for (auto mod : map->modules())
+					cached_map->add(mod->clone());
+				techmap_map_cache[map_cache_key] = cached_map;
+			}
 		}
 
 		log_header(design, "Continuing TECHMAP pass.\n");
@@ -6,5 +6,20 @@ for x in *.lib; do
     echo "read_verilog small.v" > test.ys
     echo "synth -top small" >> test.ys
     echo "dfflibmap -liberty ${x}" >> test.ys
+    echo "scratchpad -set libparse.cache 1" >> test.ys
+    echo "stat -liberty ${x}" >> test.ys
+    echo "stat -liberty ${x}" >> test.ys
+    echo "read_liberty -lib -cell DFF* ${x}" >> test.ys
 	../../yosys -ql ${x%.lib}.log -s test.ys
+	test $(grep -c "Using cached data for liberty file" ${x%.lib}.log) -eq 1
 done
+
+echo "Running filtered read_liberty.."
+cat > test.ys << "EOT"
+read_liberty -lib -cell dff -cell *adder normal.lib
+select -assert-any dff
+select -assert-any halfadder
+select -assert-any fulladder
+select -assert-none inv nand2 latch aoi211
+EOT
+../../yosys -ql filtered.log -s test.ys
@@ -1,8 +1,14 @@
-module top(input [3:0] i, output [3:0] o);
+module top(input [3:0] i, output [3:0] o, input [7:0] j, output [7:0] p);
 	python_inv #(
 	  .width(4)
 	) inv (
 		.i(i),
 		.o(o),
 	);
+	python_inv #(
+	  .width(8)
+	) inv8 (
+		.i(j),
+		.o(p),
+	);
 endmodule
@@ -54,14 +54,19 @@ def map_parameter(parameter):
 def call(input_json):
 	input = json.loads(input_json)
 	if input["method"] == "modules":
-		return json.dumps({"modules": modules()})
+		return json.dumps({"modules": modules(), "derive_batch": True})
 	if input["method"] == "derive":
-		try:
-			frontend, source = derive(input["module"],
-				{name: map_parameter(value) for name, value in input["parameters"].items()})
-			return json.dumps({"frontend": frontend, "source": source})
-		except ValueError as e:
-			return json.dumps({"error": str(e)})
+		if "batch" in input:
+			return json.dumps({"batch": [derive_one(request) for request in input["batch"]]})
+		return json.dumps(derive_one(input))
+
+def derive_one(request):
+	try:
+		frontend, source = derive(request["module"],
+			{name: map_parameter(value) for name, value in request["parameters"].items()})
+		return {"frontend": frontend, "source": source}
+	except ValueError as e:
+		return {"error": str(e)}
 
 def main():
 	parser = argparse.ArgumentParser()
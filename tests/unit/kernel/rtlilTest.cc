@@ -11,4 +11,50 @@ TEST(KernelRtlilTest, getReferenceValid)
 	EXPECT_EQ(33, 33);
 }
 
+TEST(KernelRtlilTest, moduleChanges)
+{
+	RTLIL::Design design;
+	RTLIL::Module *module = design.addModule("\\top");
+	unsigned int changes = module->changes();
+
+	RTLIL::Wire *a = module->addWire("\\a");
+	RTLIL::Wire *y = module->addWire("\\y");
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	RTLIL::Cell *cell = module->addCell("\\c", "$_NOT_");
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	cell->setPort("\\A", a);
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	cell->setPort("\\A", a);
+	EXPECT_EQ(changes, module->changes());
+
+	changes = module->changes();
+	module->connect(y, a);
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	cell->setParam("\\P", RTLIL::Const(1));
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	cell->getPort("\\A");
+	cell->hasParam("\\P");
+	module->wire("\\a");
+	module->connections();
+	EXPECT_EQ(changes, module->changes());
+
+	changes = module->changes();
+	cell->unsetPort("\\A");
+	EXPECT_NE(changes, module->changes());
+
+	changes = module->changes();
+	module->remove(cell);
+	EXPECT_NE(changes, module->changes());
+}
+
 YOSYS_NAMESPACE_END
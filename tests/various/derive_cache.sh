@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# Test re-using derived parametric modules from the on-disk derive cache.
+
+set -e
+
+rm -rf derive_cache.dir
+mkdir derive_cache.dir
+
+cat > derive_cache.v << "EOT"
+module top(input [7:0] a, output [7:0] y, z);
+	sub #(.P(3)) s1 (.a(a), .y(y));
+	sub #(.P(5)) s2 (.a(a), .y(z));
+endmodule
+
+module sub #(parameter P = 0) (input [7:0] a, output [7:0] y);
+	assign y = a + P;
+endmodule
+EOT
+
+echo -n "  populate cache - "
+../../yosys -p 'read_verilog derive_cache.v; scratchpad -set ast.derive_cache derive_cache.dir; hierarchy -top top; write_ilang derive_cache_1.il' \
+		| grep -c "Generating RTLIL representation for module .\$paramod" | grep -q 2
+test $(ls derive_cache.dir/*.il | wc -l) -eq 2
+echo "ok"
+
+echo -n "  load from cache - "
+../../yosys -p 'read_verilog derive_cache.v; scratchpad -set ast.derive_cache derive_cache.dir; hierarchy -top top; write_ilang derive_cache_2.il' \
+		| grep -c "from derive cache" | grep -q 2
+cmp derive_cache_1.il derive_cache_2.il
+echo "ok"
+
+echo -n "  corrupted cache file - "
+f=$(ls derive_cache.dir/*.il | head -n 1)
+head -c 100 $f > derive_cache.tmp && mv derive_cache.tmp $f
+../../yosys -p 'read_verilog derive_cache.v; scratchpad -set ast.derive_cache derive_cache.dir; hierarchy -top top; write_ilang derive_cache_3.il' > derive_cache.log
+test $(grep -c "from derive cache" derive_cache.log) -eq 1
+grep -q "Warning: Derive cache file .* is corrupted" derive_cache.log
+cmp derive_cache_1.il derive_cache_3.il
+echo "ok"
+
+rm -rf derive_cache.dir derive_cache.v derive_cache.log derive_cache_3.il derive_cache_1.il derive_cache_2.il
@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+# Test that the cell library snapshots built by 'make' match parsing the Verilog source.
+
+set -e
+
+if [ ! -f ../../share/ecp5/cells_sim.lib.rtlil_bin ]; then
+	echo "No cell library snapshots in share/, skipping."
+	exit 0
+fi
+
+for lib in ecp5/cells_sim.v xilinx/cells_xtra.v; do
+	../../yosys -q -l lib_snapshot.log -p "read_verilog -lib +/$lib; write_ilang lib_snapshot_1.il"
+	grep -q "Loading snapshot" lib_snapshot.log
+	# defines set with verilog_defines disable the snapshot
+	../../yosys -q -l lib_snapshot.log -p "verilog_defines -DLIB_SNAPSHOT_TEST; read_verilog -lib +/$lib; write_ilang lib_snapshot_2.il"
+	if grep -q "Loading snapshot" lib_snapshot.log; then exit 1; fi
+	# the snapshot was built from the source tree, so src attributes and
+	# auto-generated names contain a different path to the library
+	cmp <(grep -v "attribute .src" lib_snapshot_1.il | sed -E 's#[^ $]*share/#share/#g') \
+			<(grep -v "attribute .src" lib_snapshot_2.il | sed -E 's#[^ $]*share/#share/#g')
+done
+
+rm -f lib_snapshot.log lib_snapshot_1.il lib_snapshot_2.il
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# Test that the opt loop only revisits the modules changed by the previous iteration,
+# as long as they are a small part of the design.
+
+set -e
+
+cat > opt_worklist.v << "EOT"
+module sub(input [7:0] a, b, c, output [7:0] y);
+	assign y = ((a ^ b) + (a & c)) * (b | c) - (a - c);
+endmodule
+
+module top(input [7:0] a, b, c, input e, f, output [7:0] y);
+	wire unused = e & f;
+	sub s (.a(a), .b(b), .c(c), .y(y));
+endmodule
+EOT
+
+echo -n "  opt worklist - "
+# clean up sub beforehand, so that only top changes in the first iteration
+../../yosys -l opt_worklist.log -q -p 'read_verilog opt_worklist.v; hierarchy -top top; opt_clean sub; opt'
+sed -n '/Rerunning OPT passes on 1 changed modules/,/Rerunning OPT passes on the whole design/p' opt_worklist.log > opt_worklist.txt
+grep -q "Finding unused cells or wires in module .top" opt_worklist.txt
+if grep -q "module .sub" opt_worklist.txt; then
+	echo "FAIL: unchanged module sub was revisited"
+	exit 1
+fi
+echo "ok"
+
+echo -n "  opt worklist (flat) - "
+../../yosys -l opt_worklist.log -q -p 'read_verilog opt_worklist.v; hierarchy -top top; flatten; opt'
+if grep -q "Rerunning OPT passes on .* changed modules" opt_worklist.log; then
+	echo "FAIL: worklist used for a flat design"
+	exit 1
+fi
+echo "ok"
+
+rm -f opt_worklist.v opt_worklist.log opt_worklist.txt
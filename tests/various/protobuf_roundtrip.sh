@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+# Test a write_protobuf / read_protobuf round trip.
+
+set -e
+
+echo -n "  protobuf round trip - "
+
+if ! ../../yosys -q -p "help read_protobuf" > /dev/null 2>&1; then
+	echo "skipped (no protobuf support)"
+	exit 0
+fi
+
+cat > protobuf_roundtrip.ys << "EOT"
+read_verilog << EOF
+(* lut_init = 16'hbeef, wide = 40'h89abcdef01, undef = 4'b10x1 *)
+module top(input clk, input [3:0] a, b, output reg [4:0] q, output [1:0] p);
+	always @(posedge clk) q <= a + b;
+	assign p = {a[0], 1'b1};
+endmodule
+EOF
+proc
+design -save gold
+write_protobuf protobuf_roundtrip.pb
+design -reset
+read_protobuf protobuf_roundtrip.pb
+write_ilang protobuf_roundtrip.il
+design -stash gate
+
+design -copy-from gold -as gold top
+design -copy-from gate -as gate top
+equiv_make gold gate equiv
+hierarchy -top equiv
+equiv_simple
+equiv_induct
+equiv_status -assert
+EOT
+
+../../yosys -q protobuf_roundtrip.ys
+grep -q "parameter .CLK_POLARITY 1'1" protobuf_roundtrip.il
+grep -q "parameter .WIDTH 5$" protobuf_roundtrip.il
+grep -q "attribute .lut_init 16'1011111011101111" protobuf_roundtrip.il
+grep -q "attribute .wide 40'1000100110101011110011011110111100000001" protobuf_roundtrip.il
+grep -q "attribute .undef 4'10x1" protobuf_roundtrip.il
+echo "ok"
+
+rm -f protobuf_roundtrip.ys protobuf_roundtrip.pb protobuf_roundtrip.il
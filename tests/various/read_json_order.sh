@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+# Test module order and duplicate module keys in read_json.
+
+set -e
+
+cat > read_json_order.json << "EOT"
+{
+  "creator": "test",
+  "modules": {
+    "b": { "ports": { "x": { "direction": "input", "bits": [ 2 ] } }, "cells": { }, "netnames": { } },
+    "a": { "ports": { }, "cells": { }, "netnames": { } },
+    "b": { "ports": { "y": { "direction": "output", "bits": [ 2 ] } }, "cells": { }, "netnames": { } },
+    "c": { "ports": { }, "cells": { }, "netnames": { } }
+  }
+}
+EOT
+
+echo -n "  module order - "
+../../yosys -q -p 'read_json read_json_order.json; write_json read_json_order_out.json'
+test "$(grep -o '^    "[a-z]": {' read_json_order_out.json | tr -d ' ":{\n')" = "bac"
+echo "ok"
+
+echo -n "  duplicate module keys - "
+../../yosys -q -p 'read_json read_json_order.json; select -assert-count 1 b/y; select -assert-none b/x'
+echo "ok"
+
+rm -f read_json_order.json read_json_order_out.json
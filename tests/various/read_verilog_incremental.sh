@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Test re-reading Verilog files with read_verilog -incremental.
+
+set -e
+
+cat > incremental_a.v << "EOT"
+module a(input x, output y);
+	assign y = x;
+endmodule
+EOT
+
+cat > incremental_b.v << "EOT"
+module b(input x, output y);
+	assign y = x;
+endmodule
+EOT
+
+cat > incremental.ys << "EOT"
+read_verilog -incremental incremental_a.v incremental_b.v
+read_verilog -incremental incremental_a.v incremental_b.v
+!sed -i 's/= x/= ~x/' incremental_b.v
+read_verilog -incremental incremental_a.v incremental_b.v
+select -assert-count 1 b/t:$not
+select -assert-count 0 a/t:$not
+EOT
+
+echo -n "  incremental re-read - "
+../../yosys -q -l incremental.log incremental.ys
+test $(grep -c "Skipping unchanged file .incremental_a.v" incremental.log) -eq 2
+test $(grep -c "Skipping unchanged file .incremental_b.v" incremental.log) -eq 1
+echo "ok"
+
+cat > incremental_a.v << "EOT"
+module a(input x, output y);
+	b #(.P(1)) u (.x(x), .y(y));
+endmodule
+EOT
+
+cat > incremental_b.v << "EOT"
+module b #(parameter P = 0) (input x, output y);
+	assign y = x ^ P;
+endmodule
+EOT
+
+cat > incremental.ys << "EOT"
+read_verilog -incremental -defer incremental_a.v incremental_b.v
+hierarchy -top a
+read_verilog -incremental -defer incremental_a.v incremental_b.v
+hierarchy -check -top a
+select -assert-count 1 a/u
+EOT
+
+echo -n "  incremental re-read after hierarchy - "
+../../yosys -q -l incremental.log incremental.ys
+test $(grep -c "Skipping unchanged file .incremental_a.v" incremental.log) -eq 1
+test $(grep -c "Skipping unchanged file .incremental_b.v" incremental.log) -eq 1
+echo "ok"
+
+rm -f incremental_a.v incremental_b.v incremental.ys incremental.log
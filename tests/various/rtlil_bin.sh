@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Test a write_rtlil_bin / read_rtlil_bin round trip.
+
+set -e
+
+cat > rtlil_bin.v << "EOT"
+module top(input clk, input [3:0] a, input [0:3] b, output reg [7:4] q, output [1:0] y, output z);
+	parameter P = "str";
+	parameter real R = 1.5;
+	reg [3:0] mem [0:15];
+	always @(posedge clk) begin
+		mem[a] <= b;
+		case (a)
+			4'b00x1: q <= mem[b];
+			4'b1z?0: q <= 4'bx01z;
+			default: q <= a;
+		endcase
+	end
+	sub #(.W(2)) s (.a(a[1:0]), .y(y));
+	bb u (.a(a[0]), .y(z));
+endmodule
+
+module sub #(parameter signed W = 1) (input [W-1:0] a, output [W-1:0] y);
+	assign y = ~a;
+endmodule
+
+(* blackbox *)
+module bb(input a, output y);
+endmodule
+EOT
+
+echo -n "  round trip - "
+../../yosys -q -p 'read_verilog rtlil_bin.v; write_ilang rtlil_bin_1.il; write_rtlil_bin rtlil_bin.bin'
+../../yosys -q -p 'read_rtlil_bin rtlil_bin.bin; write_ilang rtlil_bin_2.il'
+cmp rtlil_bin_1.il rtlil_bin_2.il
+echo "ok"
+
+echo -n "  only selected modules - "
+../../yosys -q -p 'read_rtlil_bin -module sub -module bb rtlil_bin.bin; select -assert-none top; select -assert-any sub; select -assert-any bb'
+echo "ok"
+
+echo -n "  truncated file - "
+head -c 200 rtlil_bin.bin > rtlil_bin_trunc.bin
+if ../../yosys -q -p 'read_rtlil_bin rtlil_bin_trunc.bin' > rtlil_bin.log 2>&1; then
+	echo "FAIL: truncated file was accepted"
+	exit 1
+fi
+grep -q "is truncated or corrupted" rtlil_bin.log
+echo "ok"
+
+rm -f rtlil_bin.v rtlil_bin.bin rtlil_bin_trunc.bin rtlil_bin_1.il rtlil_bin_2.il rtlil_bin.log
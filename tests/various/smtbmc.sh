@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Test bounded model checking with the smtbmc command.
+
+set -e
+
+cat > smtbmc.sv << "EOT"
+module top(input clk, input en, output reg [3:0] cnt = 0);
+	always @(posedge clk)
+		if (en) cnt <= cnt + 1;
+	always @*
+		assert (cnt != 4'd5);
+endmodule
+EOT
+
+# a solver that exits right away must give an error, not kill yosys with SIGPIPE
+echo -n "  terminated solver - "
+mkdir -p smtbmc_bin
+printf '#!/bin/sh\nexit 0\n' > smtbmc_bin/z3
+chmod +x smtbmc_bin/z3
+if PATH="$PWD/smtbmc_bin:$PATH" ../../yosys -p "read_verilog -formal smtbmc.sv; prep -top top; smtbmc -s z3 -t 5" > smtbmc.log 2>&1; then
+	echo "FAIL: solver termination was not reported"
+	exit 1
+fi
+grep -q "SMT solver .z3. terminated unexpectedly" smtbmc.log
+rm -rf smtbmc_bin
+echo "ok"
+
+if command -v yices-smt2 > /dev/null; then
+	solver=yices
+elif command -v z3 > /dev/null; then
+	solver=z3
+else
+	echo "  smtbmc - skipped (neither yices-smt2 nor z3 found)"
+	rm -f smtbmc.sv smtbmc.log
+	exit 0
+fi
+
+echo -n "  passing bound - "
+../../yosys -q -p "read_verilog -formal smtbmc.sv; prep -top top; smtbmc -s $solver -t 5 -verify"
+echo "ok"
+
+echo -n "  failing assertion - "
+if ../../yosys -p "read_verilog -formal smtbmc.sv; prep -top top; smtbmc -s $solver -t 10 -verify" > smtbmc.log 2>&1; then
+	echo "FAIL: assertion failure was not reported"
+	exit 1
+fi
+grep -q "BMC failed in step 5" smtbmc.log
+grep -q "step   4: en = 1'b1" smtbmc.log
+echo "ok"
+
+rm -f smtbmc.sv smtbmc.log